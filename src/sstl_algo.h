@@ -3,6 +3,7 @@
 
 #include "sstl_iterator.h"
 #include "sstl_algobase.h"
+#include "sstl_functional.h"
 
 
 namespace sstl {
@@ -271,45 +272,221 @@ generate_n(_OutputIter __first, _Size __n,
 }
 
 /**
- * @brief   Return true if the sorted range
- *          [__first1, __last1) is a subsequence
- *          of the sorted range [__first2, __last2)
- * @param   __first1, __last1: the sorted range of
- *          elements to examine
- * @param   __first2, __last2: the sorted range of
- *          elements to search for
+ * @brief   Compare two values of possibly different
+ *          types with operator<
  */
-template <class _InputIter1, class _InputIter2>
-bool
-includes(_InputIter1 __first1, _InputIter1 __last1,
-         _InputIter2 __first2, _InputIter2 __last2)
+struct __iter_less {
+    template <class _Tp1, class _Tp2>
+    bool operator()(const _Tp1& __x, const _Tp2& __y) const
+    { return __x < __y; }
+};
+
+/**
+ * @brief   Return the first element in the sorted range
+ *          [__first, __last) which is not less than __val,
+ *          given that *__first is less than __val. The range
+ *          is probed at distances 1, 3, 7, 15... and the last
+ *          step is searched in halves, so finding an element
+ *          d positions away takes O(log d) comparisons
+ */
+template <class _RandomAccessIter, class _Tp, class _Compare>
+_RandomAccessIter
+__gallop_lower_bound(_RandomAccessIter __first,
+                     _RandomAccessIter __last,
+                     const _Tp& __val, _Compare __comp)
+{
+    typedef typename __iterator_traits<_RandomAccessIter>::difference_type _Distance;
+    _Distance len = __last - __first;
+    _Distance lo = 0, hi = 1; // *(__first + lo) is less than __val
+    while(hi < len && __comp(__first[hi], __val)) {
+        lo = hi;
+        hi = 2 * hi + 1;
+    }
+    if(hi > len)
+        hi = len;
+
+    // the answer is in (lo, hi]
+    __first += lo + 1;
+    len = hi - lo - 1;
+    while(len > 0) {
+        _Distance half = len >> 1;
+        if(__comp(__first[half], __val)) {
+            __first += half + 1;
+            len -= half + 1;
+        } else
+            len = half;
+    }
+    return __first;
+}
+
+/**
+ * @brief   Skip the elements of a sorted random access range
+ *          which are less than a value by galloping
+ */
+template <class _Compare>
+struct __gallop_seek {
+    _Compare m_comp;
+
+    __gallop_seek(const _Compare& __comp): m_comp(__comp) {}
+
+    template <class _RandomAccessIter, class _Tp>
+    _RandomAccessIter operator()(_RandomAccessIter __first,
+                                 _RandomAccessIter __last,
+                                 const _Tp& __val) const
+    { return sstl::__gallop_lower_bound(__first, __last, __val, m_comp); }
+};
+
+/*
+ * The set operations below walk both ranges in lockstep. When both
+ * ranges support random access they skip a run of smaller elements
+ * with one seek instead, __seek1(__first1, __last1, __val) returning
+ * the first element of range 1 not less than __val. Intersecting k
+ * elements with n elements then takes O(k log(n / k)) comparisons
+ * instead of O(k + n). The seeking versions are shared by the
+ * containers that can seek faster than by stepping, like set
+ */
+
+template <class _InputIter1, class _InputIter2, class _Compare>
+bool __includes(_InputIter1 __first1, _InputIter1 __last1,
+                _InputIter2 __first2, _InputIter2 __last2,
+                _Compare __comp,
+                input_iterator_tag, input_iterator_tag)
 {
     while(__first1 != __last1 && __first2 != __last2)
-        if(*__first2 < *__first1)
+        if(__comp(*__first2, *__first1))
             return false;
-        else if(*__first1 < *__first2)
+        else if(__comp(*__first1, *__first2))
             ++__first1;
         else
             ++__first1, ++__first2;
     return __first2 == __last2;
 }
 
-template <class _InputIter1, class _InputIter2,
-          class _Compare>
-bool includes(_InputIter1 __first1, _InputIter1 __last1,
-              _InputIter2 __first2, _InputIter2 __last2,
-              _Compare __comp)
+template <class _Iter1, class _Iter2, class _Compare, class _Seek1>
+bool __includes_seek(_Iter1 __first1, _Iter1 __last1,
+                     _Iter2 __first2, _Iter2 __last2,
+                     _Compare __comp, _Seek1 __seek1)
 {
     while(__first1 != __last1 && __first2 != __last2)
         if(__comp(*__first2, *__first1))
             return false;
         else if(__comp(*__first1, *__first2))
-            ++__first1;
+            __first1 = __seek1(__first1, __last1, *__first2);
         else
             ++__first1, ++__first2;
     return __first2 == __last2;
 }
 
+template <class _RandomAccessIter1, class _RandomAccessIter2,
+          class _Compare>
+inline bool
+__includes(_RandomAccessIter1 __first1, _RandomAccessIter1 __last1,
+           _RandomAccessIter2 __first2, _RandomAccessIter2 __last2,
+           _Compare __comp,
+           random_access_iterator_tag, random_access_iterator_tag)
+{
+    return sstl::__includes_seek(__first1, __last1, __first2, __last2,
+            __comp, __gallop_seek<_Compare>(__comp));
+}
+
+/**
+ * @brief   Return true if the sorted range
+ *          [__first1, __last1) is a subsequence
+ *          of the sorted range [__first2, __last2)
+ * @param   __first1, __last1: the sorted range of
+ *          elements to examine
+ * @param   __first2, __last2: the sorted range of
+ *          elements to search for
+ */
+template <class _InputIter1, class _InputIter2>
+inline bool
+includes(_InputIter1 __first1, _InputIter1 __last1,
+         _InputIter2 __first2, _InputIter2 __last2)
+{
+    return sstl::__includes(__first1, __last1, __first2, __last2,
+            __iter_less(), __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _Compare>
+inline bool
+includes(_InputIter1 __first1, _InputIter1 __last1,
+         _InputIter2 __first2, _InputIter2 __last2,
+         _Compare __comp)
+{
+    return sstl::__includes(__first1, __last1, __first2, __last2,
+            __comp, __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+_OutputIter
+__set_union(_InputIter1 __first1, _InputIter1 __last1,
+            _InputIter2 __first2, _InputIter2 __last2,
+            _OutputIter __result, _Compare __comp,
+            input_iterator_tag, input_iterator_tag)
+{
+    while(__first1 != __last1 && __first2 != __last2) {
+        if(__comp(*__first1, *__first2)) {
+            *__result = *__first1;
+            ++__first1;
+        } else if(__comp(*__first2, *__first1)) {
+            *__result = *__first2;
+            ++__first2;
+        } else {
+            *__result = *__first1;
+            ++__first1;
+            ++__first2;
+        }
+        ++__result;
+    }
+    return sstl::copy(__first2, __last2,
+            sstl::copy(__first1, __last1, __result));
+}
+
+template <class _Iter1, class _Iter2, class _OutputIter,
+          class _Compare, class _Seek1, class _Seek2>
+_OutputIter
+__set_union_seek(_Iter1 __first1, _Iter1 __last1,
+                 _Iter2 __first2, _Iter2 __last2,
+                 _OutputIter __result, _Compare __comp,
+                 _Seek1 __seek1, _Seek2 __seek2)
+{
+    while(__first1 != __last1 && __first2 != __last2) {
+        if(__comp(*__first1, *__first2)) {
+            _Iter1 next = __seek1(__first1, __last1, *__first2);
+            __result = sstl::copy(__first1, next, __result);
+            __first1 = next;
+        } else if(__comp(*__first2, *__first1)) {
+            _Iter2 next = __seek2(__first2, __last2, *__first1);
+            __result = sstl::copy(__first2, next, __result);
+            __first2 = next;
+        } else {
+            *__result = *__first1;
+            ++__first1;
+            ++__first2;
+            ++__result;
+        }
+    }
+    return sstl::copy(__first2, __last2,
+            sstl::copy(__first1, __last1, __result));
+}
+
+template <class _RandomAccessIter1, class _RandomAccessIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+__set_union(_RandomAccessIter1 __first1, _RandomAccessIter1 __last1,
+            _RandomAccessIter2 __first2, _RandomAccessIter2 __last2,
+            _OutputIter __result, _Compare __comp,
+            random_access_iterator_tag, random_access_iterator_tag)
+{
+    return sstl::__set_union_seek(__first1, __last1, __first2, __last2,
+            __result, __comp, __gallop_seek<_Compare>(__comp),
+            __gallop_seek<_Compare>(__comp));
+}
+
 /**
  * @brief   Constructs a sorted union beginning at
  *          __result consisting of the set of elements
@@ -322,27 +499,89 @@ bool includes(_InputIter1 __first1, _InputIter1 __last1,
  */
 template <class _InputIter1, class _InputIter2,
           class _OutputIter>
-_OutputIter
+inline _OutputIter
 set_union(_InputIter1 __first1, _InputIter1 __last1,
           _InputIter2 __first2, _InputIter2 __last2,
           _OutputIter __result)
+{
+    return sstl::__set_union(__first1, __last1, __first2, __last2,
+            __result, __iter_less(), __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+set_union(_InputIter1 __first1, _InputIter1 __last1,
+          _InputIter2 __first2, _InputIter2 __last2,
+          _OutputIter __result, _Compare __comp)
+{
+    return sstl::__set_union(__first1, __last1, __first2, __last2,
+            __result, __comp, __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+_OutputIter
+__set_intersection(_InputIter1 __first1, _InputIter1 __last1,
+                   _InputIter2 __first2, _InputIter2 __last2,
+                   _OutputIter __result, _Compare __comp,
+                   input_iterator_tag, input_iterator_tag)
 {
     while(__first1 != __last1 && __first2 != __last2) {
-        if(*__first1 < *__first2) {
+        if(__comp(*__first1, *__first2)) {
+            ++__first1;
+        } else if(__comp(*__first2, *__first1)) {
+            ++__first2;
+        } else {
             *__result = *__first1;
             ++__first1;
-        } else if(*__first2 < *__first1) {
-            *__result = *__first2;
             ++__first2;
+            ++__result;
+        }
+    }
+    return __result;
+}
+
+template <class _Iter1, class _Iter2, class _OutputIter,
+          class _Compare, class _Seek1, class _Seek2>
+_OutputIter
+__set_intersection_seek(_Iter1 __first1, _Iter1 __last1,
+                        _Iter2 __first2, _Iter2 __last2,
+                        _OutputIter __result, _Compare __comp,
+                        _Seek1 __seek1, _Seek2 __seek2)
+{
+    while(__first1 != __last1 && __first2 != __last2) {
+        if(__comp(*__first1, *__first2)) {
+            __first1 = __seek1(__first1, __last1, *__first2);
+        } else if(__comp(*__first2, *__first1)) {
+            __first2 = __seek2(__first2, __last2, *__first1);
         } else {
             *__result = *__first1;
             ++__first1;
             ++__first2;
+            ++__result;
         }
-        ++__result;
     }
-    sstl::copy(__first2, __last2,
-            sstl::copy(__first1, __last1, __result));
+    return __result;
+}
+
+template <class _RandomAccessIter1, class _RandomAccessIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+__set_intersection(_RandomAccessIter1 __first1,
+                   _RandomAccessIter1 __last1,
+                   _RandomAccessIter2 __first2,
+                   _RandomAccessIter2 __last2,
+                   _OutputIter __result, _Compare __comp,
+                   random_access_iterator_tag,
+                   random_access_iterator_tag)
+{
+    return sstl::__set_intersection_seek(__first1, __last1,
+            __first2, __last2, __result, __comp,
+            __gallop_seek<_Compare>(__comp),
+            __gallop_seek<_Compare>(__comp));
 }
 
 /**
@@ -357,26 +596,95 @@ set_union(_InputIter1 __first1, _InputIter1 __last1,
  */
 template <class _InputIter1, class _InputIter2,
           class _OutputIter>
-_OutputIter
+inline _OutputIter
 set_intersection(_InputIter1 __first1,
                  _InputIter1 __last1,
                  _InputIter2 __first2,
                  _InputIter2 __last2,
                  _OutputIter __result)
+{
+    return sstl::__set_intersection(__first1, __last1,
+            __first2, __last2, __result, __iter_less(),
+            __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+set_intersection(_InputIter1 __first1,
+                 _InputIter1 __last1,
+                 _InputIter2 __first2,
+                 _InputIter2 __last2,
+                 _OutputIter __result, _Compare __comp)
+{
+    return sstl::__set_intersection(__first1, __last1,
+            __first2, __last2, __result, __comp,
+            __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+_OutputIter
+__set_difference(_InputIter1 __first1, _InputIter1 __last1,
+                 _InputIter2 __first2, _InputIter2 __last2,
+                 _OutputIter __result, _Compare __comp,
+                 input_iterator_tag, input_iterator_tag)
 {
     while(__first1 != __last1 && __first2 != __last2) {
-        if(*__first1 < *__first2) {
+        if(__comp(*__first1, *__first2)) {
+            *__result = *__first1;
             ++__first1;
-        } else if(*__first2 < *__first1) {
+            ++__result;
+        } else if(__comp(*__first2, *__first1)) {
             ++__first2;
         } else {
-            *__result = *__first1;
             ++__first1;
             ++__first2;
-            ++__result;
         }
     }
-    return __result;
+    return sstl::copy(__first1, __last1, __result);
+}
+
+template <class _Iter1, class _Iter2, class _OutputIter,
+          class _Compare, class _Seek1, class _Seek2>
+_OutputIter
+__set_difference_seek(_Iter1 __first1, _Iter1 __last1,
+                      _Iter2 __first2, _Iter2 __last2,
+                      _OutputIter __result, _Compare __comp,
+                      _Seek1 __seek1, _Seek2 __seek2)
+{
+    while(__first1 != __last1 && __first2 != __last2) {
+        if(__comp(*__first1, *__first2)) {
+            _Iter1 next = __seek1(__first1, __last1, *__first2);
+            __result = sstl::copy(__first1, next, __result);
+            __first1 = next;
+        } else if(__comp(*__first2, *__first1)) {
+            __first2 = __seek2(__first2, __last2, *__first1);
+        } else {
+            ++__first1;
+            ++__first2;
+        }
+    }
+    return sstl::copy(__first1, __last1, __result);
+}
+
+template <class _RandomAccessIter1, class _RandomAccessIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+__set_difference(_RandomAccessIter1 __first1,
+                 _RandomAccessIter1 __last1,
+                 _RandomAccessIter2 __first2,
+                 _RandomAccessIter2 __last2,
+                 _OutputIter __result, _Compare __comp,
+                 random_access_iterator_tag,
+                 random_access_iterator_tag)
+{
+    return sstl::__set_difference_seek(__first1, __last1,
+            __first2, __last2, __result, __comp,
+            __gallop_seek<_Compare>(__comp),
+            __gallop_seek<_Compare>(__comp));
 }
 
 /**
@@ -391,26 +699,103 @@ set_intersection(_InputIter1 __first1,
  */
 template <class _InputIter1, class _InputIter2,
           class _OutputIter>
-_OutputIter
+inline _OutputIter
 set_difference(_InputIter1 __first1,
                _InputIter1 __last1,
                _InputIter2 __first2,
                _InputIter2 __last2,
                _OutputIter __result)
+{
+    return sstl::__set_difference(__first1, __last1,
+            __first2, __last2, __result, __iter_less(),
+            __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+set_difference(_InputIter1 __first1,
+               _InputIter1 __last1,
+               _InputIter2 __first2,
+               _InputIter2 __last2,
+               _OutputIter __result, _Compare __comp)
+{
+    return sstl::__set_difference(__first1, __last1,
+            __first2, __last2, __result, __comp,
+            __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+_OutputIter
+__set_symmetric_difference(_InputIter1 __first1,
+                           _InputIter1 __last1,
+                           _InputIter2 __first2,
+                           _InputIter2 __last2,
+                           _OutputIter __result, _Compare __comp,
+                           input_iterator_tag, input_iterator_tag)
 {
     while(__first1 != __last1 && __first2 != __last2) {
-        if(*__first1 < *__first2) {
+        if(__comp(*__first1, *__first2)) {
             *__result = *__first1;
             ++__first1;
             ++__result;
-        } else if(*__first2 < *__first1) {
+        } else if(__comp(*__first2, *__first1)) {
+            *__result = *__first2;
             ++__first2;
+            ++__result;
         } else {
             ++__first1;
             ++__first2;
         }
     }
-    return sstl::copy(__first1, __last1, __result);
+    return sstl::copy(__first2, __last2,
+            sstl::copy(__first1, __last1, __result));
+}
+
+template <class _Iter1, class _Iter2, class _OutputIter,
+          class _Compare, class _Seek1, class _Seek2>
+_OutputIter
+__set_symmetric_difference_seek(_Iter1 __first1, _Iter1 __last1,
+                                _Iter2 __first2, _Iter2 __last2,
+                                _OutputIter __result, _Compare __comp,
+                                _Seek1 __seek1, _Seek2 __seek2)
+{
+    while(__first1 != __last1 && __first2 != __last2) {
+        if(__comp(*__first1, *__first2)) {
+            _Iter1 next = __seek1(__first1, __last1, *__first2);
+            __result = sstl::copy(__first1, next, __result);
+            __first1 = next;
+        } else if(__comp(*__first2, *__first1)) {
+            _Iter2 next = __seek2(__first2, __last2, *__first1);
+            __result = sstl::copy(__first2, next, __result);
+            __first2 = next;
+        } else {
+            ++__first1;
+            ++__first2;
+        }
+    }
+    return sstl::copy(__first2, __last2,
+            sstl::copy(__first1, __last1, __result));
+}
+
+template <class _RandomAccessIter1, class _RandomAccessIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+__set_symmetric_difference(_RandomAccessIter1 __first1,
+                           _RandomAccessIter1 __last1,
+                           _RandomAccessIter2 __first2,
+                           _RandomAccessIter2 __last2,
+                           _OutputIter __result, _Compare __comp,
+                           random_access_iterator_tag,
+                           random_access_iterator_tag)
+{
+    return sstl::__set_symmetric_difference_seek(__first1, __last1,
+            __first2, __last2, __result, __comp,
+            __gallop_seek<_Compare>(__comp),
+            __gallop_seek<_Compare>(__comp));
 }
 
 /**
@@ -424,29 +809,283 @@ set_difference(_InputIter1 __first1,
  */
 template <class _InputIter1, class _InputIter2,
           class _OutputIter>
-_OutputIter
+inline _OutputIter
 set_symmetric_difference(_InputIter1 __first1,
                          _InputIter1 __last1,
                          _InputIter2 __first2,
                          _InputIter2 __last2,
                          _OutputIter __result)
 {
-    while(__first1 != __last1 && __first2 != __last2) {
-        if(*__first1 < *__first2) {
-            *__result = *__first1;
-            ++__first1;
-            ++__result;
-        } else if(*__first2 < *__first1) {
-            *__result = *__first2;
-            ++__first2;
-            ++__result;
-        } else {
-            ++__first1;
-            ++__first2;
-        };
+    return sstl::__set_symmetric_difference(__first1, __last1,
+            __first2, __last2, __result, __iter_less(),
+            __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+template <class _InputIter1, class _InputIter2,
+          class _OutputIter, class _Compare>
+inline _OutputIter
+set_symmetric_difference(_InputIter1 __first1,
+                         _InputIter1 __last1,
+                         _InputIter2 __first2,
+                         _InputIter2 __last2,
+                         _OutputIter __result, _Compare __comp)
+{
+    return sstl::__set_symmetric_difference(__first1, __last1,
+            __first2, __last2, __result, __comp,
+            __ITERATOR_CATEGORY(__first1),
+            __ITERATOR_CATEGORY(__first2));
+}
+
+/**
+ * @brief   Return an iterator to the first element in the
+ *          sorted range [__first, __last) which is not less
+ *          than __val
+ * @param   __first, __last: the sorted range to examine
+ * @param   __val: value to compare the elements to
+ * @param   __comp: returns true if the element (first
+ *          argument) is less than __val (second argument)
+ */
+template <class _ForwardIter, class _Tp, class _Compare>
+_ForwardIter
+lower_bound(_ForwardIter __first, _ForwardIter __last,
+            const _Tp& __val, _Compare __comp)
+{
+    typedef typename __iterator_traits<_ForwardIter>::difference_type _Distance;
+    _Distance len = __DISTANCE(__first, __last);
+    while(len > 0) {
+        _Distance half = len >> 1;
+        _ForwardIter middle = __first;
+        __ADVANCE(middle, half);
+        if(__comp(*middle, __val)) {
+            __first = middle;
+            ++__first;
+            len = len - half - 1;
+        } else
+            len = half;
     }
-    return sstl::copy(__first2, __last2,
-            sstl::copy(__first1, __last1, __result));
+    return __first;
+}
+
+template <class _ForwardIter, class _Tp>
+inline _ForwardIter
+lower_bound(_ForwardIter __first, _ForwardIter __last,
+            const _Tp& __val)
+{ return sstl::lower_bound(__first, __last, __val, sstl::less<_Tp>()); }
+
+/**
+ * @brief   Return an iterator to the first element in the
+ *          sorted range [__first, __last) which is greater
+ *          than __val
+ * @param   __first, __last: the sorted range to examine
+ * @param   __val: value to compare the elements to
+ * @param   __comp: returns true if __val (first argument)
+ *          is less than the element (second argument)
+ */
+template <class _ForwardIter, class _Tp, class _Compare>
+_ForwardIter
+upper_bound(_ForwardIter __first, _ForwardIter __last,
+            const _Tp& __val, _Compare __comp)
+{
+    typedef typename __iterator_traits<_ForwardIter>::difference_type _Distance;
+    _Distance len = __DISTANCE(__first, __last);
+    while(len > 0) {
+        _Distance half = len >> 1;
+        _ForwardIter middle = __first;
+        __ADVANCE(middle, half);
+        if(__comp(__val, *middle))
+            len = half;
+        else {
+            __first = middle;
+            ++__first;
+            len = len - half - 1;
+        }
+    }
+    return __first;
+}
+
+template <class _ForwardIter, class _Tp>
+inline _ForwardIter
+upper_bound(_ForwardIter __first, _ForwardIter __last,
+            const _Tp& __val)
+{ return sstl::upper_bound(__first, __last, __val, sstl::less<_Tp>()); }
+
+/**
+ * @brief   Check whether an element equivalent to __val
+ *          appears in the sorted range [__first, __last)
+ */
+template <class _ForwardIter, class _Tp, class _Compare>
+inline bool
+binary_search(_ForwardIter __first, _ForwardIter __last,
+              const _Tp& __val, _Compare __comp)
+{
+    _ForwardIter i = sstl::lower_bound(__first, __last, __val, __comp);
+    return i != __last && !__comp(__val, *i);
+}
+
+template <class _ForwardIter, class _Tp>
+inline bool
+binary_search(_ForwardIter __first, _ForwardIter __last,
+              const _Tp& __val)
+{ return sstl::binary_search(__first, __last, __val, sstl::less<_Tp>()); }
+
+// ranges shorter than this are left to insertion sort
+const int __sstl_sort_threshold = 16;
+
+template <class _RandomAccessIter, class _Tp, class _Compare>
+void __unguarded_linear_insert(_RandomAccessIter __last,
+                               _Tp __val, _Compare __comp)
+{
+    _RandomAccessIter next = __last;
+    --next;
+    while(__comp(__val, *next)) {
+        *__last = *next;
+        __last = next;
+        --next;
+    }
+    *__last = __val;
+}
+
+template <class _RandomAccessIter, class _Compare>
+void __insertion_sort(_RandomAccessIter __first,
+                      _RandomAccessIter __last, _Compare __comp)
+{
+    typedef typename __iterator_traits<_RandomAccessIter>::value_type _Tp;
+    if(__first == __last)
+        return;
+    for(_RandomAccessIter i = __first + 1; i != __last; ++i) {
+        _Tp val = *i;
+        if(__comp(val, *__first)) {
+            sstl::copy_backward(__first, i, i + 1);
+            *__first = val;
+        } else
+            __unguarded_linear_insert(i, val, __comp);
+    }
+}
+
+template <class _Tp, class _Compare>
+inline const _Tp&
+__median(const _Tp& __a, const _Tp& __b, const _Tp& __c, _Compare __comp)
+{
+    if(__comp(__a, __b))
+        if(__comp(__b, __c))
+            return __b;
+        else if(__comp(__a, __c))
+            return __c;
+        else
+            return __a;
+    else if(__comp(__a, __c))
+        return __a;
+    else if(__comp(__b, __c))
+        return __c;
+    else
+        return __b;
+}
+
+template <class _RandomAccessIter, class _Tp, class _Compare>
+_RandomAccessIter
+__unguarded_partition(_RandomAccessIter __first,
+                      _RandomAccessIter __last,
+                      _Tp __pivot, _Compare __comp)
+{
+    while(true) {
+        while(__comp(*__first, __pivot))
+            ++__first;
+        --__last;
+        while(__comp(__pivot, *__last))
+            --__last;
+        if(!(__first < __last))
+            return __first;
+        sstl::iter_swap(__first, __last);
+        ++__first;
+    }
+}
+
+/**
+ * @brief   Heap sort used when quick sort recurses too deep
+ */
+template <class _RandomAccessIter, class _Distance, class _Tp, class _Compare>
+void __sort_sift_down(_RandomAccessIter __first, _Distance __hole,
+                      _Distance __len, _Tp __val, _Compare __comp)
+{
+    _Distance child = 2 * __hole + 1;
+    while(child < __len) {
+        if(child + 1 < __len && __comp(*(__first + child), *(__first + child + 1)))
+            ++child;
+        if(!__comp(__val, *(__first + child)))
+            break;
+        *(__first + __hole) = *(__first + child);
+        __hole = child;
+        child = 2 * __hole + 1;
+    }
+    *(__first + __hole) = __val;
+}
+
+template <class _RandomAccessIter, class _Compare>
+void __heap_sort(_RandomAccessIter __first,
+                 _RandomAccessIter __last, _Compare __comp)
+{
+    typedef typename __iterator_traits<_RandomAccessIter>::value_type _Tp;
+    typedef typename __iterator_traits<_RandomAccessIter>::difference_type _Distance;
+    _Distance len = __last - __first;
+    for(_Distance i = len / 2; i > 0; --i)
+        sstl::__sort_sift_down(__first, i - 1, len, _Tp(*(__first + i - 1)), __comp);
+    for(; len > 1; --len) {
+        _Tp val = *(__first + len - 1);
+        *(__first + len - 1) = *__first;
+        sstl::__sort_sift_down(__first, _Distance(0), len - 1, val, __comp);
+    }
+}
+
+template <class _RandomAccessIter, class _Size, class _Compare>
+void __introsort_loop(_RandomAccessIter __first,
+                      _RandomAccessIter __last,
+                      _Size __depth_limit, _Compare __comp)
+{
+    typedef typename __iterator_traits<_RandomAccessIter>::value_type _Tp;
+    while(__last - __first > __sstl_sort_threshold) {
+        if(__depth_limit == 0) {
+            sstl::__heap_sort(__first, __last, __comp);
+            return;
+        }
+        --__depth_limit;
+        _RandomAccessIter cut = sstl::__unguarded_partition(__first, __last,
+                _Tp(sstl::__median(*__first, *(__first + (__last - __first) / 2),
+                             *(__last - 1), __comp)), __comp);
+        sstl::__introsort_loop(cut, __last, __depth_limit, __comp);
+        __last = cut;
+    }
+}
+
+/**
+ * @brief   Sort the elements in the range [__first, __last)
+ *          in ascending order, the order of equal elements
+ *          is not preserved
+ * @param   __first, __last: the range of elements to sort
+ * @param   __comp: returns true if the first argument is
+ *          less than the second
+ */
+template <class _RandomAccessIter, class _Compare>
+inline void
+sort(_RandomAccessIter __first, _RandomAccessIter __last,
+     _Compare __comp)
+{
+    typedef typename __iterator_traits<_RandomAccessIter>::difference_type _Distance;
+    if(__last - __first < 2)
+        return;
+    _Distance depth = 0;
+    for(_Distance n = __last - __first; n > 1; n >>= 1)
+        ++depth;
+    sstl::__introsort_loop(__first, __last, depth * 2, __comp);
+    sstl::__insertion_sort(__first, __last, __comp);
+}
+
+template <class _RandomAccessIter>
+inline void
+sort(_RandomAccessIter __first, _RandomAccessIter __last)
+{
+    typedef typename __iterator_traits<_RandomAccessIter>::value_type _Tp;
+    sstl::sort(__first, __last, sstl::less<_Tp>());
 }
 
 } // sstl
@@ -6,6 +6,7 @@
 #include "sstl_config.h"
 #include <iostream>
 #include <string>
+#include <cstring>
 
 
 namespace sstl {
@@ -93,7 +94,7 @@ iter_swap(_ForwardIter __it1, _ForwardIter __it2) {
  * @param   __a, __b: values to swap
  */
 template <class _Tp>
-inline void swap(const _Tp& __a, const _Tp& __b) {
+inline void swap(_Tp& __a, _Tp& __b) {
     _Tp tmp = __a;
     __a = __b;
     __b = tmp;
@@ -164,7 +165,8 @@ inline _Tp*
 __copy_trivial(const _Tp* __first, const _Tp* __last,
                _Tp* __result)
 {
-    memmove(__result, __first, sizeof(_Tp) * (__last - __first));
+    if(__first != __last)   // an empty vector has null pointers
+        memmove(__result, __first, sizeof(_Tp) * (__last - __first));
     return __result + (__last - __first);
 }
 
@@ -270,7 +272,8 @@ __copy_backward_dispatch(_Tp* __first, _Tp* __last,
                          _Tp* __result, __true_type)
 {
     const ptrdiff_t n = __last - __first;
-    memmove(__result - n, __first, sizeof(_Tp) * n);
+    if(n != 0)
+        memmove(__result - n, __first, sizeof(_Tp) * n);
     return __result - n;
 }
 
@@ -285,7 +288,8 @@ copy_backward(_BidirectionalIter1 __first,
               _BidirectionalIter1 __last,
               _BidirectionalIter2 __result)
 {
-    typedef typename __type_traits<_BidirectionalIter1>::has_trivial_assignment_operator _Trivial;
+    typedef typename __iterator_traits<_BidirectionalIter1>::value_type _Tp;
+    typedef typename __type_traits<_Tp>::has_trivial_assignment_operator _Trivial;
     return __copy_backward_dispatch(__first, __last,
                                     __result, _Trivial());
 }
@@ -79,10 +79,10 @@ private:
         }
     }
 
-    // no need of instance
+public:
+    // containers default construct their allocator_type
     __malloc_alloc_template() = default;
 
-public:
     /**
      * @brief   Wrapper of malloc
      * @param   __n: size of memory block
@@ -104,6 +104,14 @@ public:
         free(__p);
     }
 
+    /**
+     * @brief   Same as above, the size is accepted so that
+     *          simple_alloc can be used on top of this allocator
+     */
+    static void deallocate(void *__p, size_t) {
+        free(__p);
+    }
+
     /**
      * @brief   Wrapper of realloc function
      * @param   __p: pointer to memory block which will be changed
@@ -175,7 +183,7 @@ private:
      * @param   __nobjs: number of memory block
      * @return  Pointer to the start of memory block
      */
-    static char* _s_chunk_alloc(size_t __size, int __nobjs) {
+    static char* _s_chunk_alloc(size_t __size, int& __nobjs) {
         char *result;
         size_t total_bytes = __size * __nobjs; // total size of bytes
         size_t bytes_left = m_end_free - m_start_free; // remaining memory in memory pool
@@ -238,27 +246,28 @@ private:
     #else
         #define NOBJS __SSTL_DEFAULT_NOBJS
     #endif
-        char *chunk = _s_chunk_alloc(__n, NOBJS);
-
-    #if NOBJS > 1
-        // NOBJS == 1, no need to put into freelist
-        // NOBJS > 1, put the rest of memory block into freelist
-        obj *current_obj, *next_obj;
-        obj **my_free_list = m_free_list + _s_freelist_index(__n);
-        *my_free_list = next_obj = (obj*) (chunk + __n);
-
-        // link all memory block
-        for (int i = 1; ; i++) {
-            current_obj = next_obj;
-            next_obj = (obj*) ((char*) next_obj + __n);
-            if (i == NOBJS - 1) {
-                current_obj->free_list_link = nullptr;
-                break;
-            } else {
-                current_obj->free_list_link = next_obj;
+        int nobjs = NOBJS; // updated to the number of blocks really obtained
+        char *chunk = _s_chunk_alloc(__n, nobjs);
+
+        // nobjs == 1, no need to put into freelist
+        // nobjs > 1, put the rest of memory block into freelist
+        if (nobjs > 1) {
+            obj *current_obj, *next_obj;
+            obj **my_free_list = m_free_list + _s_freelist_index(__n);
+            *my_free_list = next_obj = (obj*) (chunk + __n);
+
+            // link all memory block
+            for (int i = 1; ; i++) {
+                current_obj = next_obj;
+                next_obj = (obj*) ((char*) next_obj + __n);
+                if (i == nobjs - 1) {
+                    current_obj->free_list_link = nullptr;
+                    break;
+                } else {
+                    current_obj->free_list_link = next_obj;
+                }
             }
         }
-    #endif
         return chunk;
     }
 
@@ -339,7 +348,7 @@ public:
 
     static void deallocate(T *__p, size_t __n) {
         if( __n != 0 ) {
-            Alloc::deallocate(__p, __n);
+            Alloc::deallocate(__p, sizeof(T) * __n);
         }
     }
 
@@ -0,0 +1,386 @@
+#ifndef SSTL_BLOOM_FILTER_H
+#define SSTL_BLOOM_FILTER_H
+
+#include <cstring>
+#include <cstdint>
+#include "sstl_config.h"
+#include "sstl_alloc.h"
+#include "sstl_algobase.h"
+#include "sstl_functional.h"
+#include "sstl_hashtable.h"
+#include "sstl_hash_set.h"
+#include "sstl_pair.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Blocked Bloom filter: a set of keys which may answer that
+ *          a key is there when it isn't, with a small probability,
+ *          but never that a key isn't there when it is. Keys can't
+ *          be removed.
+ *
+ *          The bits are split into blocks of one cache line, eight
+ *          64 bit words, and a key sets one bit in each word of the
+ *          one block picked by its hash. A lookup therefore reads a
+ *          single cache line, and the eight words are tested with
+ *          no branches, which compilers turn into SIMD code. With
+ *          the default 12 bits per key about 0.5% of the keys not
+ *          inserted are reported as present
+ */
+template <class _Key,
+          class _HashFunc = std::hash<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class bloom_filter {
+public:
+    typedef _Key key_type;
+    typedef _HashFunc hasher;
+    typedef size_t size_type;
+    typedef _Alloc allocator_type;
+
+private:
+    typedef unsigned long long _Word;
+    typedef __SSTL_ALLOC(_Word, _Alloc) word_allocator;
+
+    enum {
+        __block_words = 8,          // one 64 byte cache line
+        __block_bits = 64 * __block_words
+    };
+
+    hasher m_hash;
+    _Word* m_storage;               // as allocated
+    _Word* m_words;                 // m_storage aligned to a cache line
+    size_type m_blocks;
+    size_type m_count;              // number of keys inserted
+
+    /**
+     * @brief   Odd multipliers spreading the low 32 bits of a hash
+     *          to the bit index in each word of a block
+     */
+    static unsigned int _salt(int __i)
+    {
+        static const unsigned int salt[__block_words] = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+        };
+        return salt[__i];
+    }
+
+    _Word* _block(size_t __h) const
+    {
+#if __SIZEOF_SIZE_T__ == 8
+        return m_words + ((__h >> 32) * m_blocks >> 32) * __block_words;
+#else
+        return m_words + (__h % m_blocks) * __block_words;
+#endif
+    }
+
+    void _allocate(size_type __blocks)
+    {
+        const size_type n = __blocks * __block_words + __block_words - 1;
+        m_storage = word_allocator::allocate(n);
+        m_words = (_Word*)(((uintptr_t)m_storage + 63) & ~uintptr_t(63));
+        m_blocks = __blocks;
+    }
+
+    void _deallocate()
+    {
+        word_allocator::deallocate(m_storage,
+                                   m_blocks * __block_words + __block_words - 1);
+    }
+
+public:
+    /**
+     * @brief   Make a filter for about __n keys, using __bits_per_key
+     *          bits for each of them. More bits give fewer false
+     *          positives: 8 bits about 2.5%, 12 bits 0.5%, 16 bits 0.1%
+     */
+    explicit bloom_filter(size_type __n, size_type __bits_per_key = 12,
+                          const hasher& __hf = hasher())
+     : m_hash(__hf), m_storage(0), m_words(0), m_blocks(0), m_count(0)
+    {
+        // at least one block, lookups always touch one
+        const size_type bits = sstl::max(sstl::max(__n, size_type(1)) * __bits_per_key,
+                                         size_type(__block_bits));
+        _allocate((bits + __block_bits - 1) / __block_bits);
+        clear();
+    }
+
+    bloom_filter(const bloom_filter& __x)
+     : m_hash(__x.m_hash), m_storage(0), m_words(0), m_blocks(0),
+       m_count(__x.m_count)
+    {
+        _allocate(__x.m_blocks);
+        std::memcpy(m_words, __x.m_words, m_blocks * __block_words * sizeof(_Word));
+    }
+
+    bloom_filter& operator=(const bloom_filter& __x)
+    {
+        if(this != &__x) {
+            bloom_filter tmp(__x);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~bloom_filter() { _deallocate(); }
+
+    hasher hash_func() const { return m_hash; }
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+    /**
+     * @brief   Return the number of keys inserted, counting
+     *          a key inserted twice twice
+     */
+    size_type size() const { return m_count; }
+
+    bool empty() const { return m_count == 0; }
+
+    /**
+     * @brief   Return the number of cache line blocks
+     */
+    size_type block_count() const { return m_blocks; }
+
+    /**
+     * @brief   Return the number of bits of the filter
+     */
+    size_type bit_count() const { return m_blocks * __block_bits; }
+
+    void swap(bloom_filter& __x)
+    {
+        sstl::swap(m_hash, __x.m_hash);
+        sstl::swap(m_storage, __x.m_storage);
+        sstl::swap(m_words, __x.m_words);
+        sstl::swap(m_blocks, __x.m_blocks);
+        sstl::swap(m_count, __x.m_count);
+    }
+
+    /**
+     * @brief   Remove all keys
+     */
+    void clear()
+    {
+        std::memset(m_words, 0, m_blocks * __block_words * sizeof(_Word));
+        m_count = 0;
+    }
+
+    /**
+     * @brief   Insert key __k
+     */
+    void insert(const key_type& __k)
+    {
+        const size_t h = __hash_fmix(m_hash(__k));
+        _Word* block = _block(h);
+        const unsigned int low = (unsigned int)h;
+        for(int i = 0; i < __block_words; ++i)
+            block[i] |= _Word(1) << ((low * _salt(i)) >> 26);
+        ++m_count;
+    }
+
+    /**
+     * @brief   Return false if __k has not been inserted, or true if
+     *          it may have been
+     */
+    bool contains(const key_type& __k) const
+    {
+        const size_t h = __hash_fmix(m_hash(__k));
+        const _Word* block = _block(h);
+        const unsigned int low = (unsigned int)h;
+        _Word missing = 0;
+        for(int i = 0; i < __block_words; ++i)
+            missing |= ~block[i] & (_Word(1) << ((low * _salt(i)) >> 26));
+        return missing == 0;
+    }
+
+    /**
+     * @brief   Return 0 if __k has not been inserted, or 1 if
+     *          it may have been
+     */
+    size_type count(const key_type& __k) const
+    { return contains(__k) ? 1 : 0; }
+};
+
+/**
+ * @brief   Set adapter keeping a bloom_filter of the keys of _Set, a
+ *          hash_set or set, so that count and find for keys not in
+ *          the set return after reading one cache line of the filter
+ *          instead of walking a chain or a tree path. It pays off
+ *          when most lookups miss and a miss in _Set costs more than
+ *          one cache line, as in a set, or in a hash_set with a high
+ *          load factor or expensive key comparisons. A hash_set miss
+ *          at the default load factor is about as cheap as the filter.
+ *
+ *          The filter doubles when the set outgrows it. Erasing
+ *          leaves the bits of the erased keys set, which only adds
+ *          false positives, and the filter is rebuilt once there are
+ *          more erased keys than elements
+ */
+template <class _Key,
+          class _Set = hash_set<_Key, _Key>,
+          class _HashFunc = std::hash<_Key> >
+class bloom_set {
+public:
+    typedef typename _Set::key_type         key_type;
+    typedef typename _Set::value_type       value_type;
+    typedef typename _Set::size_type        size_type;
+    typedef typename _Set::iterator         iterator;
+    typedef typename _Set::const_iterator   const_iterator;
+    typedef typename _Set::reference        reference;
+    typedef typename _Set::const_reference  const_reference;
+
+    typedef bloom_filter<_Key, _HashFunc>   filter_type;
+
+protected:
+    _Set m_set;
+    filter_type m_filter;
+    size_type m_capacity;       // number of keys the filter is sized for
+    size_type m_bits_per_key;
+    size_type m_stale;          // erased keys still in the filter
+
+    enum { __min_capacity = 1024 };
+
+    /**
+     * @brief   Replace the filter by one sized for __n keys,
+     *          holding the keys of the set
+     */
+    void _rebuild(size_type __n)
+    {
+        __n = sstl::max(__n, size_type(__min_capacity));
+        filter_type tmp(__n, m_bits_per_key, m_filter.hash_func());
+        for(const_iterator it = m_set.begin(); it != m_set.end(); ++it)
+            tmp.insert(*it);
+        m_filter.swap(tmp);
+        m_capacity = __n;
+        m_stale = 0;
+    }
+
+    void _erased(size_type __n)
+    {
+        m_stale += __n;
+        if(m_stale > m_set.size() && m_stale >= size_type(__min_capacity))
+            _rebuild(m_capacity);
+    }
+
+public:
+    /**
+     * @brief   Make an empty set whose filter is sized for __n keys
+     *          of __bits_per_key bits, see bloom_filter
+     */
+    explicit bloom_set(size_type __n = __min_capacity,
+                       size_type __bits_per_key = 12)
+     : m_set(), m_filter(sstl::max(__n, size_type(__min_capacity)), __bits_per_key),
+       m_capacity(sstl::max(__n, size_type(__min_capacity))),
+       m_bits_per_key(__bits_per_key), m_stale(0) {}
+
+    /**
+     * @brief   Return the number of elements
+     */
+    size_type size() const { return m_set.size(); }
+
+    /**
+     * @brief   Check whether the set is empty
+     */
+    bool empty() const { return m_set.empty(); }
+
+    iterator begin() const { return m_set.begin(); }
+
+    iterator end() const { return m_set.end(); }
+
+    /**
+     * @brief   Return the filter in front of the set
+     */
+    const filter_type& filter() const { return m_filter; }
+
+    /**
+     * @brief   Insert element into the container
+     * @param   __val: element value to insert
+     */
+    pair<iterator, bool> insert(const value_type& __val)
+    {
+        if(m_set.size() >= m_capacity)
+            _rebuild(2 * m_capacity);
+        // a key in the filter but not in the set is only a false
+        // positive, the other way around would lose the key
+        m_filter.insert(__val);
+        // setting the bits of a key already there changes nothing,
+        // so a duplicate leaves no stale key behind
+        return m_set.insert(__val);
+    }
+
+    /**
+     * @brief   Insert element(s) into the container
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class InputIter>
+    void insert(InputIter __first, InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert(*__first);
+    }
+
+    /**
+     * @brief   Find an element with key equivalent to key
+     * @param   __k: key value of the element to search for
+     */
+    iterator find(const key_type& __k) const
+    { return m_filter.contains(__k) ? m_set.find(__k) : m_set.end(); }
+
+    /**
+     * @brief   Return the number of elements with key
+     * @param   __k: key value of the elements to count
+     */
+    size_type count(const key_type& __k) const
+    { return m_filter.contains(__k) ? m_set.count(__k) : 0; }
+
+    /**
+     * @brief   Remove the element with key equivalent to __k
+     * @param   __k: key value of the elements to remove
+     */
+    size_type erase(const key_type& __k)
+    {
+        const size_type n = m_set.erase(__k);
+        _erased(n);
+        return n;
+    }
+
+    /**
+     * @brief   Remove the element at certain position
+     * @param   __it: iterator to the element to remove
+     */
+    void erase(iterator __it)
+    {
+        m_set.erase(__it);
+        _erased(1);
+    }
+
+    /**
+     * @brief   Erase all elements from the container
+     */
+    void clear()
+    {
+        m_set.clear();
+        m_filter.clear();
+        m_stale = 0;
+    }
+
+    /**
+     * @brief   Rebuild the filter for the current elements,
+     *          dropping the bits of the erased ones
+     */
+    void rebuild_filter() { _rebuild(m_set.size()); }
+
+    void swap(bloom_set& __x)
+    {
+        m_set.swap(__x.m_set);
+        m_filter.swap(__x.m_filter);
+        sstl::swap(m_capacity, __x.m_capacity);
+        sstl::swap(m_bits_per_key, __x.m_bits_per_key);
+        sstl::swap(m_stale, __x.m_stale);
+    }
+};
+
+} // sstl
+
+
+#endif // SSTL_BLOOM_FILTER_H
@@ -0,0 +1,980 @@
+#ifndef SSTL_BTREE_H
+#define SSTL_BTREE_H
+
+#include "sstl_config.h"
+#include "sstl_iterator.h"
+#include "sstl_alloc.h"
+#include "sstl_construct.h"
+#include "sstl_traits.h"
+#include "sstl_pair.h"
+#include "sstl_algobase.h"
+
+// target size of a b-tree node in bytes, a few cache lines
+#ifndef __SSTL_BTREE_NODE_SIZE
+#define __SSTL_BTREE_NODE_SIZE 256
+#endif
+
+
+namespace sstl {
+
+/**
+ * @brief   Number of values held by one b-tree node, so that
+ *          a node fills about __SSTL_BTREE_NODE_SIZE bytes
+ */
+template <class _Value>
+struct __btree_node_capacity {
+    enum {
+        __fit = (__SSTL_BTREE_NODE_SIZE - 16) / sizeof(_Value),
+        value = __fit < 5 ? 4 : (__fit > 1024 ? 1023 : __fit - 1)
+    };
+};
+
+/**
+ * @brief   Leaf node of b-tree, holding up to _Cap sorted values.
+ *          One more slot is kept so that a full node can take the
+ *          new value before it is split
+ */
+template <class _Value, size_t _Cap>
+struct __btree_node {
+    __btree_node* m_parent;
+    unsigned short m_pos;   // index of the node in the children of parent
+    unsigned short m_count; // number of values
+    bool m_leaf;
+    alignas(_Value) unsigned char m_data[sizeof(_Value) * (_Cap + 1)];
+
+    _Value* values() { return (_Value*)m_data; }
+
+    _Value& value(size_t __i) { return values()[__i]; }
+};
+
+/**
+ * @brief   Internal node of b-tree, the values of child i
+ *          are ordered before value i
+ */
+template <class _Value, size_t _Cap>
+struct __btree_internal_node: public __btree_node<_Value, _Cap> {
+    __btree_node<_Value, _Cap>* m_children[_Cap + 2];
+};
+
+template <class _Value, size_t _Cap>
+class __btree_iterator_base {
+public:
+    typedef __btree_node<_Value, _Cap>          _Node;
+    typedef __btree_internal_node<_Value, _Cap> _Internal;
+
+    _Node* m_node;
+    int m_pos;
+
+protected:
+    static _Node* _child(_Node* __x, int __i)
+    { return ((_Internal*)__x)->m_children[__i]; }
+
+    /**
+     * @brief   Move to the next value in ascending order, the
+     *          position after the last value of root is the end
+     */
+    void increment()
+    {
+        if(!m_node->m_leaf) {
+            m_node = _child(m_node, m_pos + 1);
+            while(!m_node->m_leaf)
+                m_node = _child(m_node, 0);
+            m_pos = 0;
+            return;
+        }
+        ++m_pos;
+        while(m_pos == m_node->m_count && m_node->m_parent != nullptr) {
+            m_pos = m_node->m_pos;
+            m_node = m_node->m_parent;
+        }
+    }
+
+    /**
+     * @brief   Move to the previous value in ascending order
+     */
+    void decrement()
+    {
+        if(!m_node->m_leaf) {
+            m_node = _child(m_node, m_pos);
+            while(!m_node->m_leaf)
+                m_node = _child(m_node, m_node->m_count);
+            m_pos = m_node->m_count - 1;
+            return;
+        }
+        if(m_pos > 0) {
+            --m_pos;
+            return;
+        }
+        while(m_node->m_parent != nullptr && m_node->m_pos == 0)
+            m_node = m_node->m_parent;
+        if(m_node->m_parent != nullptr) {
+            m_pos = m_node->m_pos - 1;
+            m_node = m_node->m_parent;
+        }
+    }
+};
+
+template <class _Value, size_t _Cap, class _Ref, class _Ptr>
+class __btree_iterator;
+
+/**
+ * @brief   The type a b-tree iterator converts from: iterator
+ *          for const_iterator, and for iterator a type nothing
+ *          converts to, so its copy constructor stays the default
+ */
+template <class _Value, size_t _Cap, class _Ref, class _Ptr>
+struct __btree_iterator_source {
+    typedef __btree_iterator<_Value, _Cap, _Value&, _Value*> type;
+};
+
+template <class _Value, size_t _Cap>
+struct __btree_iterator_source<_Value, _Cap, _Value&, _Value*> {
+    struct type {};
+};
+
+template <class _Value, size_t _Cap, class _Ref, class _Ptr>
+class __btree_iterator: public __btree_iterator_base<_Value, _Cap>
+{
+public:
+    typedef _Value      value_type;
+    typedef _Ref        reference;
+    typedef _Ptr        pointer;
+    typedef ptrdiff_t   difference_type;
+
+    typedef bidirectional_iterator_tag iterator_category;
+
+private:
+    typedef __btree_iterator_base<_Value, _Cap>  _Base;
+    typedef __btree_iterator<_Value, _Cap, _Ref, _Ptr> _Self;
+    typedef typename __btree_iterator_source<_Value, _Cap, _Ref, _Ptr>::type
+            _Source;
+    typedef typename _Base::_Node _Node;
+
+    using _Base::increment;
+    using _Base::decrement;
+
+public:
+    using _Base::m_node;
+    using _Base::m_pos;
+
+    __btree_iterator() = default;
+
+    __btree_iterator(_Node* __x, int __pos)
+    {
+        m_node = __x;
+        m_pos = __pos;
+    }
+
+    __btree_iterator(const __btree_iterator&) = default;
+    __btree_iterator& operator=(const __btree_iterator&) = default;
+
+    __btree_iterator(const _Source& __it)
+    {
+        m_node = __it.m_node;
+        m_pos = __it.m_pos;
+    }
+
+    reference operator*() const
+    { return m_node->value(m_pos); }
+
+    pointer operator->() const
+    { return &(operator*()); }
+
+    _Self& operator++()
+    {
+        increment();
+        return *this;
+    }
+
+    const _Self operator++(int)
+    {
+        _Self tmp = *this;
+        increment();
+        return tmp;
+    }
+
+    _Self& operator--()
+    {
+        decrement();
+        return *this;
+    }
+
+    const _Self operator--(int)
+    {
+        _Self tmp = *this;
+        decrement();
+        return tmp;
+    }
+
+    friend inline bool operator==(const _Self& __x,
+                                  const _Self& __y)
+    { return __x.m_node == __y.m_node && __x.m_pos == __y.m_pos; }
+
+    friend inline bool operator!=(const _Self& __x,
+                                  const _Self& __y)
+    { return !(__x == __y); }
+};
+
+/**
+ * @brief   B-tree keeping many sorted values in each node, so a
+ *          lookup touches one node per level instead of one per
+ *          comparison. Inserting or erasing an element invalidates
+ *          all iterators
+ */
+template <class _Key,
+          class _Value,
+          class _KeyOfValue,
+          class _Compare,
+          class _Alloc>
+class __btree {
+private:
+    enum { _Cap = __btree_node_capacity<_Value>::value,
+           _Min = _Cap / 2 }; // fewest values of a node other than root
+
+    typedef __btree_node<_Value, _Cap>          _Node;
+    typedef __btree_internal_node<_Value, _Cap> _Internal;
+
+    typedef __SSTL_ALLOC(_Node, _Alloc)         leaf_allocator_type;
+    typedef __SSTL_ALLOC(_Internal, _Alloc)     internal_allocator_type;
+
+public:
+    typedef _Key        key_type;
+    typedef _Value      value_type;
+    typedef _Value*     pointer;
+    typedef _Value&     reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+    typedef const _Value* const_pointer;
+    typedef const _Value& const_reference;
+
+    typedef _Alloc allocator_type;
+
+    typedef __btree_iterator<_Value, _Cap, _Value&, _Value*>
+            iterator;
+    typedef __btree_iterator<_Value, _Cap, const _Value&, const _Value*>
+            const_iterator;
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+private:
+    _Node* m_root;
+    size_type m_node_count; // number of values
+    _Compare m_key_compare;
+
+    static _Node*& _child(_Node* __x, size_type __i)
+    { return ((_Internal*)__x)->m_children[__i]; }
+
+    static const key_type& _key(_Node* __x, size_type __i)
+    { return _KeyOfValue()(__x->value(__i)); }
+
+    /**
+     * @brief   Allocate an empty leaf or internal node
+     */
+    _Node* _create_node(bool __leaf)
+    {
+        _Node* p = __leaf ? leaf_allocator_type::allocate(1)
+                          : (_Node*)internal_allocator_type::allocate(1);
+        p->m_parent = nullptr;
+        p->m_pos = 0;
+        p->m_count = 0;
+        p->m_leaf = __leaf;
+        return p;
+    }
+
+    /**
+     * @brief   Release a node whose values are already destroyed
+     */
+    void _deallocate_node(_Node* __x)
+    {
+        if(__x->m_leaf)
+            leaf_allocator_type::deallocate(__x);
+        else
+            internal_allocator_type::deallocate((_Internal*)__x);
+    }
+
+    /**
+     * @brief   Destroy all values and nodes of subtree __x
+     */
+    void _erase(_Node* __x)
+    {
+        if(!__x->m_leaf)
+            for(size_type i = 0; i <= __x->m_count; ++i)
+                _erase(_child(__x, i));
+        sstl::destroy(__x->values(), __x->values() + __x->m_count);
+        _deallocate_node(__x);
+    }
+
+    /**
+     * @brief   Copy subtree __x, the copy is attached to __parent
+     */
+    _Node* _copy(_Node* __x, _Node* __parent)
+    {
+        _Node* top = _create_node(__x->m_leaf);
+        top->m_parent = __parent;
+        top->m_pos = __x->m_pos;
+        size_type values = 0, children = 0;
+        __SSTL_TRY {
+            for(; values < __x->m_count; ++values)
+                sstl::construct(&top->value(values), __x->value(values));
+            if(!__x->m_leaf)
+                for(; children <= __x->m_count; ++children)
+                    _child(top, children) = _copy(_child(__x, children), top);
+        }
+    #ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            for(size_type i = 0; i < children; ++i)
+                _erase(_child(top, i));
+            sstl::destroy(top->values(), top->values() + values);
+            _deallocate_node(top);
+            throw;
+        }
+    #endif
+        top->m_count = (unsigned short)values;
+        return top;
+    }
+
+    /**
+     * @brief   Move __n values from __src to uninitialized
+     *          storage at __dst, the ranges may overlap
+     */
+    static void _move_values(_Value* __dst, _Value* __src, size_type __n)
+    {
+        if(__dst < __src) {
+            for(size_type i = 0; i < __n; ++i) {
+                sstl::construct(__dst + i, __src[i]);
+                sstl::destroy(__src + i);
+            }
+        } else if(__dst > __src) {
+            for(size_type i = __n; i > 0; --i) {
+                sstl::construct(__dst + i - 1, __src[i - 1]);
+                sstl::destroy(__src + i - 1);
+            }
+        }
+    }
+
+    /**
+     * @brief   Move __n children from __src to __dst of node __x
+     *          and update the position of each moved child
+     */
+    static void _move_children(_Node* __x, size_type __dst,
+                               _Node* __from, size_type __src,
+                               size_type __n)
+    {
+        _Node** to = &_child(__x, 0) + __dst;
+        _Node** from = &_child(__from, 0) + __src;
+        if(to < from || __x != __from)
+            for(size_type i = 0; i < __n; ++i)
+                to[i] = from[i];
+        else
+            for(size_type i = __n; i > 0; --i)
+                to[i - 1] = from[i - 1];
+        for(size_type i = 0; i < __n; ++i) {
+            to[i]->m_parent = __x;
+            to[i]->m_pos = (unsigned short)(__dst + i);
+        }
+    }
+
+    /**
+     * @brief   Return the index of the first value in __x which is
+     *          not less than __k, comparing all values without
+     *          branches so that the loop is vectorized for scalar keys
+     */
+    size_type _lower_index(_Node* __x, const key_type& __k, __true_type) const
+    {
+        size_type i = 0;
+        for(size_type j = 0; j < __x->m_count; ++j)
+            i += m_key_compare(_key(__x, j), __k);
+        return i;
+    }
+
+    /**
+     * @brief   Same as above with binary search, for keys which
+     *          are expensive to compare
+     */
+    size_type _lower_index(_Node* __x, const key_type& __k, __false_type) const
+    {
+        size_type first = 0, len = __x->m_count;
+        while(len > 0) {
+            size_type half = len / 2;
+            if(m_key_compare(_key(__x, first + half), __k)) {
+                first += half + 1;
+                len -= half + 1;
+            } else
+                len = half;
+        }
+        return first;
+    }
+
+    size_type _lower_index(_Node* __x, const key_type& __k) const
+    {
+        typedef typename __type_traits<key_type>::is_POD_type _Is_POD;
+        return _lower_index(__x, __k, _Is_POD());
+    }
+
+    /**
+     * @brief   Return the index of the first value in __x which is
+     *          greater than __k
+     */
+    size_type _upper_index(_Node* __x, const key_type& __k, __true_type) const
+    {
+        size_type i = 0;
+        for(size_type j = 0; j < __x->m_count; ++j)
+            i += !m_key_compare(__k, _key(__x, j));
+        return i;
+    }
+
+    size_type _upper_index(_Node* __x, const key_type& __k, __false_type) const
+    {
+        size_type first = 0, len = __x->m_count;
+        while(len > 0) {
+            size_type half = len / 2;
+            if(!m_key_compare(__k, _key(__x, first + half))) {
+                first += half + 1;
+                len -= half + 1;
+            } else
+                len = half;
+        }
+        return first;
+    }
+
+    size_type _upper_index(_Node* __x, const key_type& __k) const
+    {
+        typedef typename __type_traits<key_type>::is_POD_type _Is_POD;
+        return _upper_index(__x, __k, _Is_POD());
+    }
+
+    /**
+     * @brief   Split the overflowing node __x around its middle
+     *          value, which moves up into the parent
+     * @param   __x: node holding _Cap + 1 values
+     * @param   __it: position which is kept pointing
+     *          to the same value
+     */
+    void _split(_Node* __x, iterator& __it)
+    {
+        const size_type mid = __x->m_count / 2;
+        const size_type right_n = __x->m_count - mid - 1;
+
+        _Node* parent = __x->m_parent;
+        if(parent == nullptr) { // grow a new root
+            parent = _create_node(false);
+            _child(parent, 0) = __x;
+            __x->m_parent = parent;
+            __x->m_pos = 0;
+            m_root = parent;
+        }
+
+        _Node* right = _create_node(__x->m_leaf);
+        _move_values(right->values(), __x->values() + mid + 1, right_n);
+        if(!__x->m_leaf)
+            _move_children(right, 0, __x, mid + 1, right_n + 1);
+        right->m_count = (unsigned short)right_n;
+
+        // make room in parent for the middle value and right node
+        const size_type pos = __x->m_pos;
+        _move_values(parent->values() + pos + 1,
+                     parent->values() + pos, parent->m_count - pos);
+        _move_children(parent, pos + 2, parent, pos + 1,
+                       parent->m_count - pos);
+        _move_values(parent->values() + pos, __x->values() + mid, 1);
+        _child(parent, pos + 1) = right;
+        right->m_parent = parent;
+        right->m_pos = (unsigned short)(pos + 1);
+        ++parent->m_count;
+        __x->m_count = (unsigned short)mid;
+
+        if(__it.m_node == __x) {
+            if(__it.m_pos == (int)mid) {
+                __it.m_node = parent;
+                __it.m_pos = (int)pos;
+            } else if(__it.m_pos > (int)mid) {
+                __it.m_node = right;
+                __it.m_pos -= (int)mid + 1;
+            }
+        } else if(__it.m_node == parent && __it.m_pos >= (int)pos) {
+            ++__it.m_pos;
+        }
+    }
+
+    /**
+     * @brief   Insert value into leaf __x at index __i, and split
+     *          the nodes which overflow on the way up
+     */
+    iterator _insert(_Node* __x, size_type __i, const value_type& __val)
+    {
+        if(__x == nullptr) { // empty tree
+            m_root = __x = _create_node(true);
+            __i = 0;
+        }
+        _move_values(__x->values() + __i + 1, __x->values() + __i,
+                     __x->m_count - __i);
+        __SSTL_TRY {
+            sstl::construct(&__x->value(__i), __val);
+        }
+    #ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            _move_values(__x->values() + __i, __x->values() + __i + 1,
+                         __x->m_count - __i);
+            if(m_node_count == 0) {
+                _deallocate_node(m_root);
+                m_root = nullptr;
+            }
+            throw;
+        }
+    #endif
+        ++__x->m_count;
+        ++m_node_count;
+
+        iterator it(__x, (int)__i);
+        while(__x != nullptr && __x->m_count > _Cap) {
+            _Node* parent = __x->m_parent;
+            _split(__x, it);
+            __x = parent == nullptr ? m_root : parent;
+        }
+        return it;
+    }
+
+    /**
+     * @brief   Fix node __x which has fewer values than _Min, by
+     *          borrowing from a sibling or merging with it
+     */
+    void _rebalance(_Node* __x)
+    {
+        while(__x != m_root && __x->m_count < _Min) {
+            _Node* parent = __x->m_parent;
+            const size_type pos = __x->m_pos;
+            _Node* left = pos > 0 ? _child(parent, pos - 1) : nullptr;
+            _Node* right = pos < parent->m_count ? _child(parent, pos + 1) : nullptr;
+
+            if(left != nullptr && left->m_count > _Min) { // borrow from left
+                _move_values(__x->values() + 1, __x->values(), __x->m_count);
+                _move_values(__x->values(), parent->values() + pos - 1, 1);
+                _move_values(parent->values() + pos - 1,
+                             left->values() + left->m_count - 1, 1);
+                if(!__x->m_leaf) {
+                    _move_children(__x, 1, __x, 0, __x->m_count + 1);
+                    _move_children(__x, 0, left, left->m_count, 1);
+                }
+                --left->m_count;
+                ++__x->m_count;
+                return;
+            }
+            if(right != nullptr && right->m_count > _Min) { // borrow from right
+                _move_values(__x->values() + __x->m_count, parent->values() + pos, 1);
+                _move_values(parent->values() + pos, right->values(), 1);
+                _move_values(right->values(), right->values() + 1, right->m_count - 1);
+                if(!__x->m_leaf) {
+                    _move_children(__x, __x->m_count + 1, right, 0, 1);
+                    _move_children(right, 0, right, 1, right->m_count);
+                }
+                --right->m_count;
+                ++__x->m_count;
+                return;
+            }
+
+            // merge with a sibling and the value between them
+            if(left == nullptr) {
+                left = __x;
+                __x = right;
+            }
+            const size_type sep = __x->m_pos - 1;
+            _move_values(left->values() + left->m_count, parent->values() + sep, 1);
+            _move_values(left->values() + left->m_count + 1, __x->values(), __x->m_count);
+            if(!left->m_leaf)
+                _move_children(left, left->m_count + 1, __x, 0, __x->m_count + 1);
+            left->m_count += __x->m_count + 1;
+            _deallocate_node(__x);
+
+            _move_values(parent->values() + sep, parent->values() + sep + 1,
+                         parent->m_count - sep - 1);
+            _move_children(parent, sep + 1, parent, sep + 2,
+                           parent->m_count - sep - 1);
+            --parent->m_count;
+            __x = parent;
+        }
+
+        if(__x == m_root && m_root->m_count == 0) { // shrink the tree
+            if(m_root->m_leaf) {
+                _deallocate_node(m_root);
+                m_root = nullptr;
+            } else {
+                _Node* old = m_root;
+                m_root = _child(old, 0);
+                m_root->m_parent = nullptr;
+                m_root->m_pos = 0;
+                _deallocate_node(old);
+            }
+        }
+    }
+
+public:
+    __btree(): m_root(nullptr), m_node_count(0), m_key_compare() {}
+
+    explicit __btree(const _Compare& __comp)
+     : m_root(nullptr), m_node_count(0), m_key_compare(__comp) {}
+
+    __btree(const __btree& __x)
+     : m_root(nullptr), m_node_count(0), m_key_compare(__x.m_key_compare)
+    {
+        if(__x.m_root != nullptr) {
+            m_root = _copy(__x.m_root, nullptr);
+            m_node_count = __x.m_node_count;
+        }
+    }
+
+    ~__btree() { clear(); }
+
+    __btree& operator=(const __btree& __x)
+    {
+        if(this != &__x) {
+            clear();
+            m_key_compare = __x.m_key_compare;
+            if(__x.m_root != nullptr) {
+                m_root = _copy(__x.m_root, nullptr);
+                m_node_count = __x.m_node_count;
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief   Return the function object that compares keys
+     */
+    _Compare key_comp() const { return m_key_compare; }
+
+    /**
+     * @brief   Return an iterator to the smallest value
+     */
+    iterator begin()
+    {
+        _Node* x = m_root;
+        if(x != nullptr)
+            while(!x->m_leaf)
+                x = _child(x, 0);
+        return iterator(x, 0);
+    }
+
+    const_iterator begin() const
+    { return const_cast<__btree*>(this)->begin(); }
+
+    /**
+     * @brief   Return an iterator to the position
+     *          after the last value of root
+     */
+    iterator end()
+    { return iterator(m_root, m_root == nullptr ? 0 : m_root->m_count); }
+
+    const_iterator end() const
+    { return const_cast<__btree*>(this)->end(); }
+
+    /**
+     * @brief   Check whether the b-tree is empty
+     */
+    bool empty() const { return m_node_count == 0; }
+
+    /**
+     * @brief   Return the number of values
+     */
+    size_type size() const { return m_node_count; }
+
+    /**
+     * @brief   Return the maximum possible number of values
+     */
+    size_type max_size() const { return size_type(-1); }
+
+    /**
+     * @brief   Return the number of values held by one node
+     */
+    static size_type node_capacity() { return _Cap; }
+
+    /**
+     * @brief   Exchange the contents with other b-tree
+     */
+    void swap(__btree& __x)
+    {
+        _Node* r = m_root; m_root = __x.m_root; __x.m_root = r;
+        size_type n = m_node_count; m_node_count = __x.m_node_count; __x.m_node_count = n;
+        _Compare c = m_key_compare; m_key_compare = __x.m_key_compare; __x.m_key_compare = c;
+    }
+
+public:
+    /**
+     * @brief   Return an iterator pointing to the
+     *          first value that is not less than __k
+     * @param   __k: key value to search
+     */
+    iterator lower_bound(const key_type& __k)
+    {
+        iterator res = end();
+        for(_Node* x = m_root; x != nullptr; ) {
+            size_type i = _lower_index(x, __k);
+            if(i < x->m_count)
+                res = iterator(x, (int)i);
+            if(x->m_leaf)
+                break;
+            x = _child(x, i);
+        }
+        return res;
+    }
+
+    const_iterator lower_bound(const key_type& __k) const
+    { return const_cast<__btree*>(this)->lower_bound(__k); }
+
+    /**
+     * @brief   Return an iterator pointing to the
+     *          first value that is greater than __k
+     * @param   __k: key value to search
+     */
+    iterator upper_bound(const key_type& __k)
+    {
+        iterator res = end();
+        for(_Node* x = m_root; x != nullptr; ) {
+            size_type i = _upper_index(x, __k);
+            if(i < x->m_count)
+                res = iterator(x, (int)i);
+            if(x->m_leaf)
+                break;
+            x = _child(x, i);
+        }
+        return res;
+    }
+
+    const_iterator upper_bound(const key_type& __k) const
+    { return const_cast<__btree*>(this)->upper_bound(__k); }
+
+    /**
+     * @brief   Return a range containing all values with the key
+     * @param   __k: key value to compare the values to
+     */
+    pair<iterator, iterator>
+    equal_range(const key_type& __k)
+    { return pair<iterator, iterator>(lower_bound(__k), upper_bound(__k)); }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    {
+        return pair<const_iterator, const_iterator>(
+                lower_bound(__k), upper_bound(__k));
+    }
+
+    /**
+     * @brief   Find a value with key equivalent to __k
+     * @param   __k: key value of the value to search for
+     */
+    iterator find(const key_type& __k)
+    {
+        iterator j = lower_bound(__k);
+        return j == end() || m_key_compare(__k, _KeyOfValue()(*j)) ? end() : j;
+    }
+
+    const_iterator find(const key_type& __k) const
+    { return const_cast<__btree*>(this)->find(__k); }
+
+    /**
+     * @brief   Return the number of values with key __k
+     * @param   __k: key value of the values to count
+     */
+    size_type count(const key_type& __k) const
+    {
+        pair<const_iterator, const_iterator> p = equal_range(__k);
+        return (size_type)__DISTANCE(p.first, p.second);
+    }
+
+    /**
+     * @brief   Insert value whose key is not in b-tree
+     * @param   __val: value to insert
+     */
+    pair<iterator, bool> insert_unique(const value_type& __val)
+    {
+        const key_type& k = _KeyOfValue()(__val);
+        _Node* x = m_root;
+        size_type i = 0;
+        while(x != nullptr) {
+            i = _lower_index(x, k);
+            if(i < x->m_count && !m_key_compare(k, _key(x, i)))
+                return pair<iterator, bool>(iterator(x, (int)i), false);
+            if(x->m_leaf)
+                break;
+            x = _child(x, i);
+        }
+        return pair<iterator, bool>(_insert(x, i, __val), true);
+    }
+
+    /**
+     * @brief   Insert value whose key is not in b-tree, using __pos
+     *          as a hint. When the value goes right before __pos it
+     *          is put in the leaf next to __pos without searching
+     *          from the root, so end() makes appending increasing
+     *          keys cheap
+     * @param   __pos: iterator to the position before which the
+     *          value is expected to be inserted
+     * @param   __val: value to insert
+     */
+    iterator insert_unique(iterator __pos, const value_type& __val)
+    {
+        const key_type& k = _KeyOfValue()(__val);
+        if(m_node_count == 0)
+            return insert_unique(__val).first;
+        if(__pos == begin()) {
+            if(m_key_compare(k, _KeyOfValue()(*__pos)))
+                return _insert(__pos.m_node, 0, __val);
+            return insert_unique(__val).first;
+        }
+
+        iterator before = __pos;
+        --before;
+        if(m_key_compare(_KeyOfValue()(*before), k) &&
+           (__pos == end() || m_key_compare(k, _KeyOfValue()(*__pos)))) {
+            // the value before __pos is the last of a leaf, or
+            // __pos is the first value of a leaf
+            if(before.m_node->m_leaf)
+                return _insert(before.m_node, (size_type)before.m_pos + 1, __val);
+            return _insert(__pos.m_node, (size_type)__pos.m_pos, __val);
+        }
+        return insert_unique(__val).first;
+    }
+
+    /**
+     * @brief   Insert value after all values with an equivalent key
+     * @param   __val: value to insert
+     */
+    iterator insert_equal(const value_type& __val)
+    {
+        const key_type& k = _KeyOfValue()(__val);
+        _Node* x = m_root;
+        size_type i = 0;
+        while(x != nullptr) {
+            i = _upper_index(x, k);
+            if(x->m_leaf)
+                break;
+            x = _child(x, i);
+        }
+        return _insert(x, i, __val);
+    }
+
+    /**
+     * @brief   Insert values in the range [__first, __last)
+     *          whose keys are not in b-tree
+     */
+    template <class _InputIter>
+    void insert_unique(_InputIter __first, _InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert_unique(*__first);
+    }
+
+    /**
+     * @brief   Insert all values in the range [__first, __last)
+     */
+    template <class _InputIter>
+    void insert_equal(_InputIter __first, _InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert_equal(*__first);
+    }
+
+    /**
+     * @brief   Remove the value at __pos
+     * @param   __pos: iterator to the value to remove
+     */
+    void erase(iterator __pos)
+    {
+        _Node* x = __pos.m_node;
+        size_type i = (size_type)__pos.m_pos;
+        if(!x->m_leaf) {
+            // replace the value with its predecessor, which is
+            // the last value of a leaf
+            iterator pred = __pos;
+            --pred;
+            sstl::destroy(&x->value(i));
+            _move_values(&x->value(i), &pred.m_node->value(pred.m_pos), 1);
+            x = pred.m_node;
+        } else {
+            sstl::destroy(&x->value(i));
+            _move_values(x->values() + i, x->values() + i + 1,
+                         x->m_count - i - 1);
+        }
+        --x->m_count;
+        --m_node_count;
+        _rebalance(x);
+    }
+
+    /**
+     * @brief   Remove the values in the range [__first, __last). The
+     *          next value is found again by its key after each erase,
+     *          since erasing invalidates the iterators
+     */
+    void erase(iterator __first, iterator __last)
+    {
+        if(__first == begin() && __last == end()) {
+            clear();
+            return;
+        }
+        for(size_type n = (size_type)__DISTANCE(__first, __last); n > 0; --n) {
+            key_type k = _KeyOfValue()(*__first);
+            size_type before = 0; // equivalent values before __first
+            for(iterator it = lower_bound(k); it != __first; ++it)
+                ++before;
+            erase(__first);
+            __first = lower_bound(k);
+            for(; before > 0; --before)
+                ++__first;
+        }
+    }
+
+    /**
+     * @brief   Remove all values with key __k
+     * @param   __k: key value of the values to remove
+     * @return  The number of values removed
+     */
+    size_type erase(const key_type& __k)
+    {
+        size_type n = 0;
+        for(iterator it = lower_bound(__k);
+            it != end() && !m_key_compare(__k, _KeyOfValue()(*it));
+            it = lower_bound(__k)) {
+            erase(it);
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief   Remove all values from b-tree
+     */
+    void clear()
+    {
+        if(m_root != nullptr)
+            _erase(m_root);
+        m_root = nullptr;
+        m_node_count = 0;
+    }
+
+    friend inline bool operator==(const __btree& __x, const __btree& __y)
+    {
+        return __x.size() == __y.size() &&
+               sstl::equal(__x.begin(), __x.end(), __y.begin());
+    }
+
+    /**
+     * @brief   Compare the values of __x and __y lexicographically
+     */
+    friend inline bool operator<(const __btree& __x, const __btree& __y)
+    {
+        const_iterator first1 = __x.begin(), first2 = __y.begin();
+        const_iterator last1 = __x.end(), last2 = __y.end();
+        for(; first1 != last1 && first2 != last2; ++first1, ++first2) {
+            if(*first1 < *first2)
+                return true;
+            if(*first2 < *first1)
+                return false;
+        }
+        return first1 == last1 && first2 != last2;
+    }
+};
+
+} // sstl
+
+
+#endif // SSTL_BTREE_H
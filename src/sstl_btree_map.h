@@ -0,0 +1,272 @@
+#ifndef SSTL_BTREE_MAP_H
+#define SSTL_BTREE_MAP_H
+
+#include "sstl_pair.h"
+#include "sstl_alloc.h"
+#include "sstl_btree.h"
+#include "sstl_functional.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Sorted map of unique keys stored in a b-tree. It has
+ *          the interface of map, but inserting or erasing an
+ *          element invalidates all iterators and references
+ */
+template <class _Key, class _Value,
+          class _Compare = sstl::less<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class btree_map {
+public:
+    typedef _Key    key_type;
+    typedef _Value  mapped_type;
+    typedef pair<const _Key, _Value> value_type;
+    typedef _Compare key_compare;
+
+    class value_compare:
+            public binary_function<value_type, value_type, bool> {
+    private:
+        _Compare m_comp;
+
+    public:
+        value_compare(_Compare __comp): m_comp(__comp) {}
+
+        bool operator()(const value_type& __x,
+                        const value_type& __y) const
+        { return m_comp(__x.first, __y.first); }
+    };
+
+private:
+    typedef __btree<key_type, value_type,
+                    sstl::select1st<value_type>,
+                    key_compare, _Alloc> _Rep_type;
+    _Rep_type m_t;
+
+public:
+    typedef typename _Rep_type::pointer pointer;
+    typedef typename _Rep_type::reference reference;
+    typedef typename _Rep_type::difference_type difference_type;
+    typedef typename _Rep_type::size_type size_type;
+    typedef typename _Rep_type::allocator_type allocator_type;
+
+    typedef typename _Rep_type::const_pointer const_pointer;
+    typedef typename _Rep_type::const_reference const_reference;
+
+    typedef typename _Rep_type::iterator iterator;
+    typedef typename _Rep_type::const_iterator const_iterator;
+
+    btree_map(): m_t(_Compare()) {}
+    explicit btree_map(const _Compare& __comp): m_t(__comp) {}
+
+    template <class InputIter>
+    btree_map(InputIter __first, InputIter __last): m_t(_Compare())
+    { m_t.insert_unique(__first, __last); }
+
+    template <class InputIter>
+    btree_map(InputIter __first, InputIter __last,
+              _Compare __comp): m_t(__comp)
+    { m_t.insert_unique(__first, __last); }
+
+    btree_map(const btree_map<_Key, _Value, _Compare, _Alloc>& __x)
+     : m_t(__x.m_t) {}
+
+    btree_map<_Key, _Value, _Compare, _Alloc>&
+    operator=(const btree_map<_Key, _Value, _Compare, _Alloc>& __x)
+    {
+        m_t = __x.m_t;
+        return *this;
+    }
+
+    /**
+     * @brief   Return the allocator associated with map
+     */
+    allocator_type get_allocator() const
+    { return m_t.get_allocator(); }
+
+    /**
+     * @brief   Return the function that compare keys
+     */
+    key_compare key_comp() const { return m_t.key_comp(); }
+
+    /**
+     * @brief   Return the function that compares keys
+     *          in objects of type value_type
+     */
+    value_compare value_comp() const
+    { return value_compare(m_t.key_comp()); }
+
+    /**
+     * @brief   Return an iterator to the beginning
+     */
+    iterator begin() { return m_t.begin(); }
+
+    const_iterator begin() const { return m_t.begin(); }
+
+    /**
+     * @brief   Return the iterator to the end
+     */
+    iterator end() { return m_t.end(); }
+
+    const_iterator end() const { return m_t.end(); }
+
+    /**
+     * @brief   Check whether the map is empty
+     */
+    bool empty() const { return m_t.empty(); }
+
+    /**
+     * @brief   Return the number of elements
+     */
+    size_type size() const { return m_t.size(); }
+
+    /**
+     * @brief   Return the maximum possible number of elements
+     */
+    size_type max_size() const { return m_t.max_size(); }
+
+    /**
+     * @brief   access or insert specified element
+     */
+    mapped_type& operator[](const key_type& __k)
+    {
+        iterator it = m_t.lower_bound(__k);
+        if(it == end() || key_comp()(__k, it->first))
+            it = m_t.insert_unique(value_type(__k, mapped_type())).first;
+        return it->second;
+    }
+
+    /**
+     * @brief   Exchange contents of the container with other
+     */
+    void swap(btree_map<_Key, _Value, _Compare, _Alloc>& __x)
+    { m_t.swap(__x.m_t); }
+
+    /**
+     * @brief   Insert element into the container if the container
+     *          doesn't contain an element with an equivalent key
+     * @param   __val: element value to insert
+     */
+    pair<iterator, bool> insert(const value_type& __val)
+    { return m_t.insert_unique(__val); }
+
+    /**
+     * @param   __pos: iterator to the position before which the
+     *          element is expected to be inserted, end() makes
+     *          appending increasing keys cheap
+     */
+    iterator insert(iterator __pos, const value_type& __val)
+    { return m_t.insert_unique(__pos, __val); }
+
+    template <class InputIter>
+    void insert(InputIter __first, InputIter __last)
+    { m_t.insert_unique(__first, __last); }
+
+    /**
+     * @brief   Remove specified element from the container
+     * @param   __pos: iterator to the element to remove
+     */
+    void erase(iterator __pos) { m_t.erase(__pos); }
+
+    size_type erase(const key_type& __k)
+    { return m_t.erase(__k); }
+
+    void erase(iterator __first, iterator __last)
+    { m_t.erase(__first, __last); }
+
+    /**
+     * @brief   Erase all elements from the container
+     */
+    void clear() { m_t.clear(); }
+
+    /**
+     * @brief   Find element with key equivalent to key
+     */
+    iterator find(const key_type& __k)
+    { return m_t.find(__k); }
+
+    const_iterator find(const key_type& __k) const
+    { return m_t.find(__k); }
+
+    /**
+     * @brief   Return the number of elements with key that
+     *          equivalent to the specified argument
+     */
+    size_type count(const key_type& __k) const
+    { return m_t.find(__k) == m_t.end() ? 0 : 1; }
+
+    /**
+     * @brief   Return an iterator pointing to the first
+     *          element that is not less than key
+     * @param   __k: key value to compare the elements to
+     */
+    iterator lower_bound(const key_type& __k)
+    { return m_t.lower_bound(__k); }
+
+    const_iterator lower_bound(const key_type& __k) const
+    { return m_t.lower_bound(__k); }
+
+    /**
+     * @brief   Return an iterator pointing to the first
+     *          element that is greater than key
+     * @param   __k: key value to compare the elements to
+     */
+    iterator upper_bound(const key_type& __k)
+    { return m_t.upper_bound(__k); }
+
+    const_iterator upper_bound(const key_type& __k) const
+    { return m_t.upper_bound(__k); }
+
+    /**
+     * @brief   Return a range containing all elements
+     *          with the given key in the container
+     * @param   __k: key value to compare the elements to
+     */
+    pair<iterator, iterator>
+    equal_range(const key_type& __k)
+    { return m_t.equal_range(__k); }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    { return m_t.equal_range(__k); }
+
+    friend inline bool
+    operator==(const btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+               const btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+    { return __x.m_t == __y.m_t; }
+
+    friend inline bool
+    operator<(const btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+              const btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+    { return __x.m_t < __y.m_t; }
+
+    friend inline bool
+    operator!=(const btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+               const btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+    { return !(__x == __y); }
+
+    friend inline bool
+    operator>(const btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+              const btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+    { return __y < __x; }
+
+    friend inline bool
+    operator<=(const btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+               const btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+    { return !(__y < __x); }
+
+    friend inline bool
+    operator>=(const btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+               const btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+    { return !(__x < __y); }
+};
+
+template <class _Key, class _Value, class _Compare, class _Alloc>
+inline void swap(btree_map<_Key, _Value, _Compare, _Alloc>& __x,
+                 btree_map<_Key, _Value, _Compare, _Alloc>& __y)
+{ __x.swap(__y); }
+
+} // sstl
+
+
+#endif // SSTL_BTREE_MAP_H
@@ -0,0 +1,262 @@
+#ifndef SSTL_CONCURRENT_HASHTABLE_H
+#define SSTL_CONCURRENT_HASHTABLE_H
+
+#include <new>
+#include <mutex>
+#include "sstl_config.h"
+#include "sstl_alloc.h"
+#include "sstl_functional.h"
+#include "sstl_hashtable.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Hashtable which may be used by several threads at once.
+ *          The elements are spread over a power of two number of
+ *          shards by the high bits of their hash, each shard being
+ *          a hashtable with its own mutex, so threads working on
+ *          different shards never wait for each other.
+ *          There are no iterators, an iterator would outlive the
+ *          lock of its shard. find copies the element out instead
+ *          and for_each visits the elements under the shard lock.
+ *          The default allocator is the malloc based one, the pool
+ *          allocator keeps its free lists without any locking
+ */
+template <class _Key,
+          class _Value,
+          class _HashFunc,
+          class _ExtractKey,
+          class _EqualKey,
+          class _Alloc = __SSTL_ALLOC_L1(true, 0)>
+class concurrent_hashtable {
+public:
+    typedef _Key        key_type;
+    typedef _Value      value_type;
+    typedef _HashFunc   hasher;
+    typedef _EqualKey   key_equal;
+    typedef size_t      size_type;
+
+    typedef _Alloc allocator_type;
+
+    typedef hashtable<_Key, _Value, _HashFunc, _ExtractKey,
+                      _EqualKey, _Alloc> table_type;
+
+    enum { __default_concurrency = 16 };
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+private:
+    /**
+     * @brief   One shard, padded so that the mutexes of
+     *          neighbouring shards do not share a cache line
+     */
+    struct _Shard {
+        mutable std::mutex m_mutex;
+        table_type m_ht;
+        char m_pad[64];
+
+        _Shard(size_type __n, const _HashFunc& __hf,
+               const _EqualKey& __eql)
+         : m_mutex(), m_ht(__n, __hf, __eql) {}
+    };
+
+    typedef __SSTL_ALLOC(_Shard, _Alloc) shard_allocator;
+    typedef std::lock_guard<std::mutex> _Lock;
+
+    _Shard* m_shards;
+    size_type m_num_shards;
+    unsigned m_shift;   // log2(m_num_shards)
+    hasher m_hash;
+    key_equal m_equal;
+
+    _Shard& _shard_of(const key_type& __k) const
+    {
+        if(m_shift == 0)
+            return m_shards[0];
+        size_t h = __hash_mix(m_hash(__k));
+        return m_shards[h >> (sizeof(size_t) * 8 - m_shift)];
+    }
+
+    void _init_shards(size_type __n, size_type __concurrency)
+    {
+        m_num_shards = 1;
+        m_shift = 0;
+        while(m_num_shards < __concurrency) {
+            m_num_shards <<= 1;
+            ++m_shift;
+        }
+
+        size_type per_shard = __n / m_num_shards + 1;
+        m_shards = shard_allocator::allocate(m_num_shards);
+        size_type i = 0;
+        __SSTL_TRY {
+            for(; i < m_num_shards; ++i)
+                new(m_shards + i) _Shard(per_shard, m_hash, m_equal);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            while(i > 0)
+                m_shards[--i].~_Shard();
+            shard_allocator::deallocate(m_shards, m_num_shards);
+            throw;
+        }
+#endif
+    }
+
+    template <class _Function>
+    void _visit(size_type __i, _Function& __f) const
+    {
+        _Lock lock(m_shards[__i].m_mutex);
+        const table_type& ht = m_shards[__i].m_ht;
+        for(typename table_type::const_iterator it = ht.begin();
+            it != ht.end(); ++it)
+            __f(*it);
+    }
+
+public:
+    /**
+     * @param   __n: number of elements expected, split between shards
+     * @param   __concurrency: number of threads expected to use the
+     *          table at once, rounded up to a power of two shards
+     */
+    concurrent_hashtable(size_type __n,
+                         const _HashFunc& __hf,
+                         const _EqualKey& __eql,
+                         size_type __concurrency = __default_concurrency)
+     : m_shards(nullptr), m_num_shards(0), m_shift(0),
+       m_hash(__hf), m_equal(__eql)
+    { _init_shards(__n, __concurrency == 0 ? 1 : __concurrency); }
+
+    concurrent_hashtable(const concurrent_hashtable&) = delete;
+    concurrent_hashtable& operator=(const concurrent_hashtable&) = delete;
+
+    ~concurrent_hashtable()
+    {
+        for(size_type i = 0; i < m_num_shards; ++i)
+            m_shards[i].~_Shard();
+        shard_allocator::deallocate(m_shards, m_num_shards);
+    }
+
+    hasher hash_func() const { return m_hash; }
+
+    key_equal key_eq() const { return m_equal; }
+
+    /**
+     * @brief   Return the number of shards
+     */
+    size_type shard_count() const { return m_num_shards; }
+
+    /**
+     * @brief   Return the number of elements. Every shard is
+     *          locked in turn, so with concurrent writers the
+     *          result is only a snapshot
+     */
+    size_type size() const
+    {
+        size_type n = 0;
+        for(size_type i = 0; i < m_num_shards; ++i) {
+            _Lock lock(m_shards[i].m_mutex);
+            n += m_shards[i].m_ht.size();
+        }
+        return n;
+    }
+
+    bool empty() const { return size() == 0; }
+
+public:
+    /**
+     * @brief   Insert value whose key is not present yet
+     * @return  Whether the value was inserted
+     */
+    bool insert_unique(const value_type& __val)
+    {
+        _Shard& s = _shard_of(_ExtractKey()(__val));
+        _Lock lock(s.m_mutex);
+        return s.m_ht.insert_unique(__val).second;
+    }
+
+    /**
+     * @brief   Copy the element with key __k into __val
+     * @return  Whether the key was found, __val is
+     *          left untouched otherwise
+     */
+    bool find(const key_type& __k, value_type& __val) const
+    {
+        _Shard& s = _shard_of(__k);
+        _Lock lock(s.m_mutex);
+        typename table_type::const_iterator it =
+                static_cast<const table_type&>(s.m_ht).find(__k);
+        if(it == static_cast<const table_type&>(s.m_ht).end())
+            return false;
+        __val = *it;
+        return true;
+    }
+
+    size_type count(const key_type& __k) const
+    {
+        _Shard& s = _shard_of(__k);
+        _Lock lock(s.m_mutex);
+        return s.m_ht.count(__k);
+    }
+
+    /**
+     * @brief   Erase the element with key __k
+     * @return  Number of elements erased
+     */
+    size_type erase(const key_type& __k)
+    {
+        _Shard& s = _shard_of(__k);
+        _Lock lock(s.m_mutex);
+        return s.m_ht.erase(__k);
+    }
+
+    void clear()
+    {
+        for(size_type i = 0; i < m_num_shards; ++i) {
+            _Lock lock(m_shards[i].m_mutex);
+            m_shards[i].m_ht.clear();
+        }
+    }
+
+    /**
+     * @brief   Call __f on every element of shard __i while holding
+     *          its lock. Different threads may visit different shards
+     *          at once. __f must not use this table, the lock of the
+     *          shard is not recursive
+     */
+    template <class _Function>
+    _Function for_each(size_type __i, _Function __f) const
+    {
+        _visit(__i, __f);
+        return __f;
+    }
+
+    /**
+     * @brief   Call __f on every element, one shard at a time
+     */
+    template <class _Function>
+    _Function for_each(_Function __f) const
+    {
+        for(size_type i = 0; i < m_num_shards; ++i)
+            _visit(i, __f);
+        return __f;
+    }
+};
+
+/**
+ * @brief   Set of unique keys which may be used by several
+ *          threads at once, see concurrent_hashtable
+ */
+template <class _Key,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_ALLOC_L1(true, 0)>
+using concurrent_hash_set = concurrent_hashtable<_Key, _Key, _HashFunc,
+        identity<_Key>, _EqualKey, _Alloc>;
+
+} // sstl
+
+
+#endif // SSTL_CONCURRENT_HASHTABLE_H
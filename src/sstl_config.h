@@ -26,6 +26,31 @@
 #endif
 
 
+// Define before including sstl headers to keep the subtree size in
+// every rb-tree node, which makes nth(), rank() and distance() of
+// set and map logarithmic. It must be the same in every translation unit
+// #define __SSTL_RB_TREE_ORDER_STATISTICS
+
+// keep the color of an rb-tree node in the low bit of its parent
+// pointer instead of a separate field, which saves the padding of
+// a word per node. It must be the same in every translation unit
+// #define __SSTL_RB_TREE_COMPACT_NODES
+
+// let hashtable rehash and insert_unique_parallel use several threads,
+// see parallel_threads(). It includes <thread>, which may need linking
+// with the thread library
+// #define __SSTL_HASHTABLE_PARALLEL
+
+
+// ask the cpu to start loading the cache line of an address
+// which will be read soon
+#ifdef __GNUC__
+#define __SSTL_PREFETCH(_Addr)  __builtin_prefetch(_Addr)
+#else
+#define __SSTL_PREFETCH(_Addr)  ((void)0)
+#endif
+
+
 #define __SSTL_TEMPLATE_NULL    template <>
 
 #define __SSTL_BEGIN_NAMESPACE  namespace sstl {
@@ -0,0 +1,668 @@
+#ifndef SSTL_FLAT_HASHTABLE_H
+#define SSTL_FLAT_HASHTABLE_H
+
+#include "sstl_config.h"
+#include "sstl_iterator.h"
+#include "sstl_alloc.h"
+#include "sstl_construct.h"
+#include "sstl_algobase.h"
+#include "sstl_functional.h"
+#include "sstl_hashtable.h"
+#include "sstl_pair.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+namespace sstl {
+
+/*
+ * Control byte of a slot in flat_hashtable. A full slot keeps the
+ * low 7 bits of the hash of its value, so a byte compare rejects
+ * almost all slots before the keys are compared
+ */
+enum {
+    __flat_empty    = -128,
+    __flat_deleted  = -2,
+    __flat_sentinel = -1  // after the last slot, stops iteration
+};
+
+/**
+ * @brief   Return the index of the lowest set bit of a non-zero mask
+ */
+inline unsigned __flat_lowest_bit(unsigned __mask)
+{
+#ifdef __GNUC__
+    return (unsigned)__builtin_ctz(__mask);
+#else
+    unsigned i = 0;
+    for(; !(__mask & 1); __mask >>= 1)
+        ++i;
+    return i;
+#endif
+}
+
+/**
+ * @brief   The control bytes of 16 slots, which are matched
+ *          against a byte at once with SSE2 where it is available
+ */
+struct __flat_group {
+    enum { width = 16 };
+
+#ifdef __SSE2__
+    __m128i m_ctrl;
+
+    explicit __flat_group(const signed char* __p)
+     : m_ctrl(_mm_loadu_si128((const __m128i*)__p)) {}
+
+    /**
+     * @brief   Return a mask of the slots whose control byte is __b
+     */
+    unsigned match(signed char __b) const
+    {
+        return (unsigned)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_set1_epi8(__b), m_ctrl));
+    }
+
+    /**
+     * @brief   Return a mask of the slots which are empty or deleted
+     */
+    unsigned match_free() const
+    {
+        return (unsigned)_mm_movemask_epi8(
+                _mm_cmpgt_epi8(_mm_set1_epi8(__flat_sentinel), m_ctrl));
+    }
+#else
+    const signed char* m_ctrl;
+
+    explicit __flat_group(const signed char* __p): m_ctrl(__p) {}
+
+    unsigned match(signed char __b) const
+    {
+        unsigned mask = 0;
+        for(int i = 0; i < width; ++i)
+            mask |= (unsigned)(m_ctrl[i] == __b) << i;
+        return mask;
+    }
+
+    unsigned match_free() const
+    {
+        unsigned mask = 0;
+        for(int i = 0; i < width; ++i)
+            mask |= (unsigned)(m_ctrl[i] < __flat_sentinel) << i;
+        return mask;
+    }
+#endif
+
+    unsigned match_empty() const { return match(__flat_empty); }
+};
+
+template <class _Key, class _Value,
+          class _HashFunc,
+          class _ExtractKey,
+          class _EqualKey,
+          class _Alloc>
+class flat_hashtable;
+
+template <class _Value, class _Ref, class _Ptr>
+class __flat_hashtable_iterator {
+public:
+    typedef _Value      value_type;
+    typedef _Ref        reference;
+    typedef _Ptr        pointer;
+    typedef ptrdiff_t   difference_type;
+    typedef size_t      size_type;
+
+    typedef forward_iterator_tag iterator_category;
+
+private:
+    typedef __flat_hashtable_iterator<_Value, _Ref, _Ptr> _Self;
+    typedef __flat_hashtable_iterator<_Value, _Value&, _Value*> iterator;
+
+public:
+    const signed char* m_ctrl;
+    _Value* m_slot;
+
+    /**
+     * @brief   Move to the next full slot, the sentinel
+     *          after the last slot stops the search
+     */
+    void skip_free()
+    {
+        while(*m_ctrl < __flat_sentinel) {
+            ++m_ctrl;
+            ++m_slot;
+        }
+    }
+
+public:
+    __flat_hashtable_iterator(): m_ctrl(nullptr), m_slot(nullptr) {}
+
+    __flat_hashtable_iterator(const signed char* __ctrl, _Value* __slot)
+     : m_ctrl(__ctrl), m_slot(__slot) {}
+
+    __flat_hashtable_iterator(const iterator& __it)
+     : m_ctrl(__it.m_ctrl), m_slot(__it.m_slot) {}
+
+    reference operator*() const { return *m_slot; }
+
+    pointer operator->() const { return m_slot; }
+
+    _Self& operator++()
+    {
+        ++m_ctrl;
+        ++m_slot;
+        skip_free();
+        return *this;
+    }
+
+    const _Self operator++(int)
+    {
+        _Self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const _Self& __it) const
+    { return m_ctrl == __it.m_ctrl; }
+
+    bool operator!=(const _Self& __it) const
+    { return m_ctrl != __it.m_ctrl; }
+};
+
+/**
+ * @brief   Open addressing hashtable with unique keys. The values
+ *          are kept inline in one array, next to an array of one
+ *          control byte per slot. A lookup probes groups of 16
+ *          control bytes for the 7 hash bits of the key and only
+ *          compares the keys of matching slots, instead of chasing
+ *          a pointer per element like hashtable.
+ *
+ *          The capacity is a power of two and at most 7/8 of it
+ *          is used. A probe only goes on past a group without
+ *          empty slots, so erasing from a group that still has an
+ *          empty slot leaves no tombstone. Inserting or erasing
+ *          may invalidate all iterators
+ */
+template <class _Key, class _Value,
+          class _HashFunc = std::hash<_Key>,
+          class _ExtractKey = sstl::identity<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class flat_hashtable {
+public:
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef _Value* pointer;
+
+    typedef const _Value* const_pointer;
+    typedef _Value& reference;
+    typedef const _Value& const_reference;
+
+    typedef __flat_hashtable_iterator<_Value, _Value&, _Value*> iterator;
+    typedef __flat_hashtable_iterator<_Value, const _Value&, const _Value*>
+            const_iterator;
+
+    typedef _HashFunc hasher;
+    typedef _EqualKey key_equal;
+
+    typedef _Alloc allocator_type;
+
+private:
+    typedef __SSTL_ALLOC(_Value, _Alloc) slot_allocator;
+    typedef __SSTL_ALLOC(signed char, _Alloc) ctrl_allocator;
+
+    enum { __width = __flat_group::width };
+
+private:
+    hasher m_hash;
+    key_equal m_equal;
+    _ExtractKey m_getKey;
+
+    signed char* m_ctrl;    // m_capacity control bytes and a sentinel
+    _Value* m_slots;
+    size_type m_capacity;   // 0 or a power of two, at least __width
+    size_type m_size;
+    size_type m_deleted;    // slots marked __flat_deleted
+
+    static const signed char* _empty_ctrl()
+    {
+        static const signed char sentinel = __flat_sentinel;
+        return &sentinel;
+    }
+
+    /**
+     * @brief   Return the number of values the
+     *          capacity __n holds before growing
+     */
+    static size_type _growth_limit(size_type __n)
+    { return __n - __n / 8; }
+
+    size_type _hash(const key_type& __k) const
+    { return __hash_mix(m_hash(__k)); }
+
+    static signed char _h2(size_type __h)
+    { return (signed char)(__h & 0x7f); }
+
+    /**
+     * @brief   Return the index of the first group to probe,
+     *          the groups are probed by triangular steps
+     */
+    size_type _first_group(size_type __h) const
+    { return (__h >> 7) & (m_capacity / __width - 1); }
+
+    /**
+     * @brief   Return the index of the slot holding key __k
+     *          whose hash is __h, or m_capacity if there is none
+     */
+    size_type _find(const key_type& __k, size_type __h) const
+    {
+        if(m_capacity == 0)
+            return 0;
+        const size_type mask = m_capacity / __width - 1;
+        const signed char h2 = _h2(__h);
+        size_type g = _first_group(__h);
+        for(size_type step = 1; ; g = (g + step++) & mask) {
+            __flat_group group(m_ctrl + g * __width);
+            for(unsigned m = group.match(h2); m != 0; m &= m - 1) {
+                size_type i = g * __width + __flat_lowest_bit(m);
+                if(m_equal(m_getKey(m_slots[i]), __k))
+                    return i;
+            }
+            if(group.match_empty() != 0)
+                return m_capacity;
+            if(step > mask) // every group has been probed
+                return m_capacity;
+        }
+    }
+
+    /**
+     * @brief   Return the index of the first empty or deleted
+     *          slot on the probe sequence of hash __h
+     */
+    size_type _find_free(size_type __h) const
+    {
+        const size_type mask = m_capacity / __width - 1;
+        size_type g = _first_group(__h);
+        for(size_type step = 1; ; g = (g + step++) & mask) {
+            unsigned m = __flat_group(m_ctrl + g * __width).match_free();
+            if(m != 0)
+                return g * __width + __flat_lowest_bit(m);
+        }
+    }
+
+    void _set_ctrl(size_type __i, signed char __b) { m_ctrl[__i] = __b; }
+
+    /**
+     * @brief   Allocate the arrays for __n slots, all empty. The
+     *          members are only set once both allocations succeed,
+     *          so on failure the table keeps its arrays
+     */
+    void _allocate(size_type __n)
+    {
+        signed char* ctrl = ctrl_allocator::allocate(__n + 1);
+        _Value* slots = nullptr;
+        __SSTL_TRY {
+            slots = slot_allocator::allocate(__n);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            ctrl_allocator::deallocate(ctrl, __n + 1);
+            throw;
+        }
+#endif
+        sstl::fill(ctrl, ctrl + __n, (signed char)__flat_empty);
+        ctrl[__n] = __flat_sentinel;
+        m_ctrl = ctrl;
+        m_slots = slots;
+        m_capacity = __n;
+        m_deleted = 0;
+    }
+
+    void _deallocate()
+    {
+        if(m_capacity != 0) {
+            ctrl_allocator::deallocate(m_ctrl, m_capacity + 1);
+            slot_allocator::deallocate(m_slots, m_capacity);
+        }
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+    }
+
+    /**
+     * @brief   Destroy all values, leaving the slots empty
+     */
+    void _destroy_values()
+    {
+        for(size_type i = 0; i < m_capacity; ++i)
+            if(m_ctrl[i] >= 0)
+                sstl::destroy(m_slots + i);
+    }
+
+    /**
+     * @brief   Move the values to new arrays of __n slots. If the
+     *          allocation or copying a value throws, the table is
+     *          left unchanged
+     */
+    void _rehash(size_type __n)
+    {
+        signed char* old_ctrl = m_ctrl;
+        _Value* old_slots = m_slots;
+        const size_type old_n = m_capacity;
+        _allocate(__n);
+        size_type i = 0;
+        __SSTL_TRY {
+            for(; i < old_n; ++i) {
+                if(old_ctrl[i] < 0)
+                    continue;
+                size_type h = _hash(m_getKey(old_slots[i]));
+                size_type j = _find_free(h);
+                sstl::construct(m_slots + j, old_slots[i]);
+                _set_ctrl(j, _h2(h));
+            }
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            _destroy_values();
+            _deallocate();
+            m_ctrl = old_ctrl;
+            m_slots = old_slots;
+            m_capacity = old_n;
+            m_deleted = 0;
+            for(size_type j = 0; j < old_n; ++j)
+                m_deleted += old_ctrl[j] == __flat_deleted;
+            throw;
+        }
+#endif
+        for(i = 0; i < old_n; ++i)
+            if(old_ctrl[i] >= 0)
+                sstl::destroy(old_slots + i);
+        if(old_n != 0) {
+            ctrl_allocator::deallocate(old_ctrl, old_n + 1);
+            slot_allocator::deallocate(old_slots, old_n);
+        }
+    }
+
+    /**
+     * @brief   Return the smallest capacity which holds __n values
+     */
+    static size_type _capacity_for(size_type __n)
+    {
+        size_type cap = __width;
+        while(_growth_limit(cap) < __n)
+            cap *= 2;
+        return cap;
+    }
+
+    /**
+     * @brief   Make room for one more value. Tombstones are
+     *          cleared in place when they take much of the space
+     */
+    void _prepare_insert()
+    {
+        if(m_size + m_deleted < _growth_limit(m_capacity))
+            return;
+        if(m_capacity != 0 && m_size < _growth_limit(m_capacity) / 2)
+            _rehash(m_capacity);
+        else
+            _rehash(_capacity_for(m_size + 1));
+    }
+
+    void _copy_from(const flat_hashtable& __ht)
+    {
+        if(__ht.m_size == 0)
+            return;
+        _allocate(_capacity_for(__ht.m_size));
+        for(size_type i = 0; i < __ht.m_capacity; ++i) {
+            if(__ht.m_ctrl[i] < 0)
+                continue;
+            size_type j = _find_free(_hash(m_getKey(__ht.m_slots[i])));
+            sstl::construct(m_slots + j, __ht.m_slots[i]);
+            _set_ctrl(j, __ht.m_ctrl[i]);
+            ++m_size;
+        }
+    }
+
+    iterator _make_iter(size_type __i)
+    { return iterator(m_ctrl + __i, m_slots + __i); }
+
+    const_iterator _make_iter(size_type __i) const
+    { return const_iterator(m_ctrl + __i, m_slots + __i); }
+
+public:
+    flat_hashtable(size_type __n,
+                   const _HashFunc& __hf,
+                   const _EqualKey& __eql)
+     : m_hash(__hf), m_equal(__eql), m_getKey(_ExtractKey()),
+       m_ctrl(nullptr), m_slots(nullptr), m_capacity(0),
+       m_size(0), m_deleted(0)
+    {
+        if(__n != 0)
+            _allocate(_capacity_for(__n));
+    }
+
+    flat_hashtable(const flat_hashtable& __ht)
+     : m_hash(__ht.m_hash), m_equal(__ht.m_equal),
+       m_getKey(__ht.m_getKey), m_ctrl(nullptr), m_slots(nullptr),
+       m_capacity(0), m_size(0), m_deleted(0)
+    {
+        __SSTL_TRY {
+            _copy_from(__ht);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            _destroy_values();
+            _deallocate();
+            throw;
+        }
+#endif
+    }
+
+    ~flat_hashtable()
+    {
+        _destroy_values();
+        _deallocate();
+    }
+
+    flat_hashtable& operator=(const flat_hashtable& __ht)
+    {
+        if(this != &__ht) {
+            flat_hashtable tmp(__ht);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+    hasher hash_func() const { return m_hash; }
+
+    key_equal key_eq() const { return m_equal; }
+
+    size_type size() const { return m_size; }
+
+    size_type max_size() const { return size_type(-1) / sizeof(_Value); }
+
+    bool empty() const { return m_size == 0; }
+
+    void swap(flat_hashtable& __ht)
+    {
+        sstl::swap(m_hash, __ht.m_hash);
+        sstl::swap(m_equal, __ht.m_equal);
+        sstl::swap(m_getKey, __ht.m_getKey);
+        sstl::swap(m_ctrl, __ht.m_ctrl);
+        sstl::swap(m_slots, __ht.m_slots);
+        sstl::swap(m_capacity, __ht.m_capacity);
+        sstl::swap(m_size, __ht.m_size);
+        sstl::swap(m_deleted, __ht.m_deleted);
+    }
+
+    iterator begin()
+    {
+        if(m_capacity == 0)
+            return end();
+        iterator it = _make_iter(0);
+        it.skip_free();
+        return it;
+    }
+
+    const_iterator begin() const
+    { return const_cast<flat_hashtable*>(this)->begin(); }
+
+    iterator end()
+    {
+        if(m_capacity == 0)
+            return iterator(_empty_ctrl(), nullptr);
+        return _make_iter(m_capacity);
+    }
+
+    const_iterator end() const
+    { return const_cast<flat_hashtable*>(this)->end(); }
+
+    /**
+     * @brief   Insert element if the container doesn't contain
+     *          an element with an equivalent key
+     * @param   __val: element value to insert
+     */
+    pair<iterator, bool> insert_unique(const value_type& __val)
+    {
+        const size_type h = _hash(m_getKey(__val));
+        size_type i = _find(m_getKey(__val), h);
+        if(i != m_capacity)
+            return pair<iterator, bool>(_make_iter(i), false);
+
+        _prepare_insert();
+        i = _find_free(h);
+        sstl::construct(m_slots + i, __val);
+        m_deleted -= m_ctrl[i] == __flat_deleted;
+        _set_ctrl(i, _h2(h));
+        ++m_size;
+        return pair<iterator, bool>(_make_iter(i), true);
+    }
+
+    template <class _InputIter>
+    void insert_unique(_InputIter __first, _InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert_unique(*__first);
+    }
+
+    iterator find(const key_type& __k)
+    {
+        size_type i = _find(__k, _hash(__k));
+        return i == m_capacity ? end() : _make_iter(i);
+    }
+
+    const_iterator find(const key_type& __k) const
+    { return const_cast<flat_hashtable*>(this)->find(__k); }
+
+    size_type count(const key_type& __k) const
+    { return _find(__k, _hash(__k)) == m_capacity ? 0 : 1; }
+
+    pair<iterator, iterator> equal_range(const key_type& __k)
+    {
+        iterator first = find(__k), last = first;
+        if(first != end())
+            ++last;
+        return pair<iterator, iterator>(first, last);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    {
+        pair<iterator, iterator> p =
+                const_cast<flat_hashtable*>(this)->equal_range(__k);
+        return pair<const_iterator, const_iterator>(p.first, p.second);
+    }
+
+    /**
+     * @brief   Remove the element at __it. The slot is left empty if
+     *          its group has an empty slot, as no probe then went on
+     *          past the group, and is marked deleted otherwise
+     */
+    void erase(const const_iterator& __it)
+    {
+        const size_type i = __it.m_ctrl - m_ctrl;
+        sstl::destroy(m_slots + i);
+        const size_type g = i / __width * __width;
+        if(__flat_group(m_ctrl + g).match_empty() != 0)
+            _set_ctrl(i, __flat_empty);
+        else {
+            _set_ctrl(i, __flat_deleted);
+            ++m_deleted;
+        }
+        --m_size;
+    }
+
+    void erase(const_iterator __first, const_iterator __last)
+    {
+        // erasing only rewrites the control byte of the slot
+        for(; __first != __last; ++__first)
+            erase(__first);
+    }
+
+    size_type erase(const key_type& __k)
+    {
+        size_type i = _find(__k, _hash(__k));
+        if(i == m_capacity)
+            return 0;
+        erase(const_iterator(_make_iter(i)));
+        return 1;
+    }
+
+    /**
+     * @brief   Erase all elements, keeping the slots
+     */
+    void clear()
+    {
+        _destroy_values();
+        if(m_capacity != 0)
+            sstl::fill(m_ctrl, m_ctrl + m_capacity, (signed char)__flat_empty);
+        m_size = 0;
+        m_deleted = 0;
+    }
+
+    /**
+     * @brief   Grow the slots to hold __hint_n elements
+     */
+    void resize(size_type __hint_n)
+    {
+        if(__hint_n > _growth_limit(m_capacity))
+            _rehash(_capacity_for(__hint_n));
+    }
+
+    /**
+     * @brief   Return the number of slots
+     */
+    size_type bucket_count() const { return m_capacity; }
+
+    size_type max_bucket_count() const
+    { return (size_type(-1) / 2 + 1) / sizeof(_Value); }
+
+    friend bool operator==(const flat_hashtable& __x,
+                           const flat_hashtable& __y)
+    {
+        if(__x.size() != __y.size())
+            return false;
+        for(const_iterator it = __x.begin(); it != __x.end(); ++it) {
+            const_iterator j = __y.find(__x.m_getKey(*it));
+            if(j == __y.end() || !(*j == *it))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const flat_hashtable& __x,
+                           const flat_hashtable& __y)
+    { return !(__x == __y); }
+};
+
+} // sstl
+
+
+#endif // SSTL_FLAT_HASHTABLE_H
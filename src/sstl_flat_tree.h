@@ -0,0 +1,331 @@
+#ifndef SSTL_FLAT_TREE_H
+#define SSTL_FLAT_TREE_H
+
+#include "sstl_config.h"
+#include "sstl_vector.h"
+#include "sstl_algo.h"
+#include "sstl_pair.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Sorted vector of values with unique keys. Lookups are
+ *          binary searches over contiguous storage and each value
+ *          costs no more memory than the value itself, but a single
+ *          insert or erase moves the values after it. Inserting or
+ *          erasing invalidates all iterators
+ */
+template <class _Key,
+          class _Value,
+          class _KeyOfValue,
+          class _Compare,
+          class _Alloc>
+class __flat_tree {
+private:
+    typedef vector<_Value, _Alloc> _Rep_type;
+
+public:
+    typedef _Key        key_type;
+    typedef _Value      value_type;
+    typedef _Value*     pointer;
+    typedef _Value&     reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+    typedef const _Value* const_pointer;
+    typedef const _Value& const_reference;
+
+    typedef _Alloc allocator_type;
+
+    typedef _Value*         iterator;
+    typedef const _Value*   const_iterator;
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+private:
+    _Rep_type m_v;
+    _Compare m_key_compare;
+
+    /**
+     * @brief   Compare two values by their keys
+     */
+    class _Value_compare {
+    private:
+        _Compare m_comp;
+
+    public:
+        _Value_compare(const _Compare& __comp): m_comp(__comp) {}
+
+        bool operator()(const _Value& __x, const _Value& __y) const
+        { return m_comp(_KeyOfValue()(__x), _KeyOfValue()(__y)); }
+    };
+
+    const key_type& _key(const_iterator __it) const
+    { return _KeyOfValue()(*__it); }
+
+    /**
+     * @brief   Sort the values from index __old to the end, drop
+     *          the duplicate keys among them and merge them with
+     *          the sorted values before __old in one pass
+     */
+    void _merge_tail(size_type __old)
+    {
+        _Value_compare comp(m_key_compare);
+        iterator mid = m_v.begin() + __old;
+        sstl::sort(mid, m_v.end(), comp);
+
+        // keep the first of each run of equivalent keys
+        iterator last = mid;
+        for(iterator it = mid; it != m_v.end(); ++it)
+            if(last == mid || comp(*(last - 1), *it))
+                *last++ = *it;
+        m_v.erase(last, m_v.end());
+
+        if(__old == 0 || mid == m_v.end() || comp(*(mid - 1), *mid))
+            return; // already in order
+
+        _Rep_type tmp;
+        tmp.reserve(m_v.size());
+        iterator first1 = m_v.begin(), first2 = mid;
+        while(first1 != mid && first2 != m_v.end()) {
+            if(comp(*first2, *first1))
+                tmp.push_back(*first2++);
+            else {
+                if(!comp(*first1, *first2)) // key already present
+                    ++first2;
+                tmp.push_back(*first1++);
+            }
+        }
+        for(; first1 != mid; ++first1)
+            tmp.push_back(*first1);
+        for(; first2 != m_v.end(); ++first2)
+            tmp.push_back(*first2);
+        m_v.swap(tmp);
+    }
+
+public:
+    __flat_tree(): m_v(), m_key_compare() {}
+
+    explicit __flat_tree(const _Compare& __comp)
+     : m_v(), m_key_compare(__comp) {}
+
+    __flat_tree(const __flat_tree& __x)
+     : m_v(__x.m_v), m_key_compare(__x.m_key_compare) {}
+
+    __flat_tree& operator=(const __flat_tree& __x)
+    {
+        m_v = __x.m_v;
+        m_key_compare = __x.m_key_compare;
+        return *this;
+    }
+
+    /**
+     * @brief   Return the function object that compares keys
+     */
+    _Compare key_comp() const { return m_key_compare; }
+
+    iterator begin() { return m_v.begin(); }
+
+    const_iterator begin() const { return m_v.begin(); }
+
+    iterator end() { return m_v.end(); }
+
+    const_iterator end() const { return m_v.end(); }
+
+    bool empty() const { return m_v.empty(); }
+
+    size_type size() const { return m_v.size(); }
+
+    size_type max_size() const { return size_type(-1) / sizeof(_Value); }
+
+    /**
+     * @brief   Return the number of values that fit
+     *          in the allocated storage
+     */
+    size_type capacity() const { return m_v.capacity(); }
+
+    /**
+     * @brief   Allocate storage for at least __n values
+     */
+    void reserve(size_type __n) { m_v.reserve(__n); }
+
+    /**
+     * @brief   Release the storage which holds no value, useful
+     *          once a container is built and will only be read
+     */
+    void shrink_to_fit()
+    {
+        if(m_v.capacity() != m_v.size()) {
+            _Rep_type tmp(m_v); // copies allocate exactly size()
+            m_v.swap(tmp);
+        }
+    }
+
+    void swap(__flat_tree& __x)
+    {
+        m_v.swap(__x.m_v);
+        sstl::swap(m_key_compare, __x.m_key_compare);
+    }
+
+public:
+    /**
+     * @brief   Return an iterator pointing to the
+     *          first value that is not less than __k
+     */
+    iterator lower_bound(const key_type& __k)
+    {
+        iterator first = m_v.begin();
+        size_type len = m_v.size();
+        while(len > 0) {
+            size_type half = len / 2;
+            if(m_key_compare(_key(first + half), __k)) {
+                first += half + 1;
+                len -= half + 1;
+            } else
+                len = half;
+        }
+        return first;
+    }
+
+    const_iterator lower_bound(const key_type& __k) const
+    { return const_cast<__flat_tree*>(this)->lower_bound(__k); }
+
+    /**
+     * @brief   Return an iterator pointing to the
+     *          first value that is greater than __k
+     */
+    iterator upper_bound(const key_type& __k)
+    {
+        iterator first = m_v.begin();
+        size_type len = m_v.size();
+        while(len > 0) {
+            size_type half = len / 2;
+            if(!m_key_compare(__k, _key(first + half))) {
+                first += half + 1;
+                len -= half + 1;
+            } else
+                len = half;
+        }
+        return first;
+    }
+
+    const_iterator upper_bound(const key_type& __k) const
+    { return const_cast<__flat_tree*>(this)->upper_bound(__k); }
+
+    pair<iterator, iterator>
+    equal_range(const key_type& __k)
+    {
+        iterator i = lower_bound(__k);
+        if(i == end() || m_key_compare(__k, _key(i)))
+            return pair<iterator, iterator>(i, i);
+        return pair<iterator, iterator>(i, i + 1);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    {
+        pair<iterator, iterator> p =
+                const_cast<__flat_tree*>(this)->equal_range(__k);
+        return pair<const_iterator, const_iterator>(p.first, p.second);
+    }
+
+    iterator find(const key_type& __k)
+    {
+        iterator i = lower_bound(__k);
+        return i == end() || m_key_compare(__k, _key(i)) ? end() : i;
+    }
+
+    const_iterator find(const key_type& __k) const
+    { return const_cast<__flat_tree*>(this)->find(__k); }
+
+    size_type count(const key_type& __k) const
+    { return find(__k) == end() ? 0 : 1; }
+
+    /**
+     * @brief   Insert value whose key is not present yet
+     * @param   __val: value to insert
+     */
+    pair<iterator, bool> insert_unique(const value_type& __val)
+    {
+        iterator i = lower_bound(_KeyOfValue()(__val));
+        if(i != end() && !m_key_compare(_KeyOfValue()(__val), _key(i)))
+            return pair<iterator, bool>(i, false);
+        return pair<iterator, bool>(m_v.insert(i, __val), true);
+    }
+
+    /**
+     * @brief   Insert the values in the range [__first, __last)
+     *          whose keys are not present yet. The new values are
+     *          appended, sorted and merged once, which costs
+     *          O(n + k log k) instead of O(k n) for k single inserts.
+     *          Which of several new values with equivalent keys is
+     *          kept is unspecified. If copying or comparing a value
+     *          throws, the values appended so far are dropped and the
+     *          container is left as it was before the call
+     */
+    template <class _InputIter>
+    void insert_unique(_InputIter __first, _InputIter __last)
+    {
+        const size_type old = m_v.size();
+        __SSTL_TRY {
+            for(; __first != __last; ++__first)
+                m_v.push_back(*__first);
+            // only touches the values from old on until the merged
+            // values are swapped in
+            _merge_tail(old);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            m_v.erase(m_v.begin() + old, m_v.end());
+            throw;
+        }
+#endif
+    }
+
+    /**
+     * @brief   Replace the contents with the range [__first, __last)
+     *          which is sorted and free of duplicate keys
+     */
+    template <class _ForwardIter>
+    void assign_sorted(_ForwardIter __first, _ForwardIter __last)
+    {
+        _Rep_type tmp;
+        tmp.reserve((size_type)__DISTANCE(__first, __last));
+        for(; __first != __last; ++__first)
+            tmp.push_back(*__first);
+        m_v.swap(tmp);
+    }
+
+    void erase(iterator __pos) { m_v.erase(__pos); }
+
+    void erase(iterator __first, iterator __last)
+    { m_v.erase(__first, __last); }
+
+    size_type erase(const key_type& __k)
+    {
+        iterator i = find(__k);
+        if(i == end())
+            return 0;
+        m_v.erase(i);
+        return 1;
+    }
+
+    void clear() { m_v.clear(); }
+
+    friend inline bool operator==(const __flat_tree& __x,
+                                  const __flat_tree& __y)
+    {
+        return __x.size() == __y.size() &&
+               sstl::equal(__x.begin(), __x.end(), __y.begin());
+    }
+
+    friend inline bool operator!=(const __flat_tree& __x,
+                                  const __flat_tree& __y)
+    { return !(__x == __y); }
+};
+
+} // sstl
+
+
+#endif // SSTL_FLAT_TREE_H
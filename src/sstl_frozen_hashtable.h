@@ -0,0 +1,471 @@
+#ifndef SSTL_FROZEN_HASHTABLE_H
+#define SSTL_FROZEN_HASHTABLE_H
+
+#include "sstl_config.h"
+#include "sstl_alloc.h"
+#include "sstl_construct.h"
+#include "sstl_algobase.h"
+#include "sstl_functional.h"
+#include "sstl_vector.h"
+#include "sstl_hashtable.h"
+#include "sstl_pair.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Hash __h with __seed. This needs __hash_fmix rather than
+ *          __hash_mix, so that two hash values collide for about one
+ *          seed in the table size and not for all of them
+ */
+inline size_t __frozen_mix(size_t __h, unsigned int __seed)
+{
+#if __SIZEOF_SIZE_T__ == 8
+    return __hash_fmix(__h ^ (size_t(__seed) + 1) * 0x9e3779b97f4a7c15ull);
+#else
+    return __hash_fmix(__h ^ (size_t(__seed) + 1) * 0x9e3779b9u);
+#endif
+}
+
+/**
+ * @brief   Map the uniformly distributed __x to [0, __n)
+ *          with a multiply instead of a division
+ */
+inline size_t __frozen_reduce(size_t __x, size_t __n)
+{
+#if __SIZEOF_SIZE_T__ == 8 && defined(__SIZEOF_INT128__)
+    return (size_t)(((unsigned __int128)__x * __n) >> 64);
+#elif __SIZEOF_SIZE_T__ == 4
+    return (size_t)(((unsigned long long)__x * __n) >> 32);
+#else
+    return __x % __n;
+#endif
+}
+
+/**
+ * @brief   Read-only hashtable with unique keys built once from a
+ *          range, using a minimal perfect hash in the style of CHD
+ *          and PTHash (hash and displace). The keys are split into
+ *          buckets of about __bucket_load keys, and each bucket keeps
+ *          one 32 bit seed, chosen while building so that the keys of
+ *          all buckets land in distinct positions. There are about
+ *          1/8 more positions than keys, which keeps the last buckets
+ *          from trying seeds for long, and the positions past the
+ *          last value are remapped to the holes below it, so that the
+ *          values are contiguous with one per key. A lookup reads the
+ *          seed of its bucket, then compares the key of the one value
+ *          it maps to, so there are two memory accesses and no chains,
+ *          or three for the few keys which are remapped.
+ *
+ *          Buckets of one key store their value index in the seed.
+ *          Distinct keys with equal hash values can't be told apart by
+ *          any seed, so all but one of them go to a short list after
+ *          the slots, which is searched when a lookup misses
+ */
+template <class _Key, class _Value,
+          class _HashFunc = std::hash<_Key>,
+          class _ExtractKey = sstl::identity<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class frozen_hashtable {
+public:
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef const _Value* pointer;
+    typedef const _Value* const_pointer;
+    typedef const _Value& reference;
+    typedef const _Value& const_reference;
+
+    typedef const _Value* iterator;
+    typedef const _Value* const_iterator;
+
+    typedef _HashFunc hasher;
+    typedef _EqualKey key_equal;
+
+    typedef _Alloc allocator_type;
+
+private:
+    typedef unsigned int _Seed;
+
+    enum {
+        __bucket_load = 4   // average number of keys per bucket
+    };
+
+    static const _Seed __direct = 0x80000000u; // the seed is a slot
+
+    typedef __SSTL_ALLOC(_Value, _Alloc) slot_allocator;
+
+    hasher m_hash;
+    key_equal m_equal;
+    _ExtractKey m_getKey;
+
+    _Value* m_slots;                // the placed values, then the list
+    size_type m_size;
+    size_type m_placed;             // values reached through a seed
+    vector<_Seed, _Alloc> m_seeds;
+    vector<_Seed, _Alloc> m_remap;  // positions from m_placed on
+
+    size_type _bucket(size_t __h) const
+    { return __frozen_reduce(__hash_mix(__h), m_seeds.size()); }
+
+    size_type _slot(size_t __h, _Seed __seed) const
+    {
+        if(__seed & __direct)
+            return __seed & ~__direct;
+        size_type i = __frozen_reduce(__frozen_mix(__h, __seed),
+                                      m_placed + m_remap.size());
+        return i < m_placed ? i : m_remap[i - m_placed];
+    }
+
+    /**
+     * @brief   Return the index of the value with key __k,
+     *          or m_size if there is none
+     */
+    size_type _find(const key_type& __k) const
+    {
+        if(m_placed != 0) {
+            const size_t h = m_hash(__k);
+            size_type i = _slot(h, m_seeds[_bucket(h)]);
+            if(m_equal(m_getKey(m_slots[i]), __k))
+                return i;
+        }
+        for(size_type i = m_placed; i < m_size; ++i)
+            if(m_equal(m_getKey(m_slots[i]), __k))
+                return i;
+        return m_size;
+    }
+
+    /**
+     * @brief   Copy construct __n values into new slots,
+     *          the i-th one from __vals[__idx[i]]
+     */
+    static _Value* _copy_values(const _Value* __vals,
+                                const size_type* __idx, size_type __n)
+    {
+        if(__n == 0)
+            return 0;
+        _Value* slots = slot_allocator::allocate(__n);
+        size_type i = 0;
+        __SSTL_TRY {
+            for(; i < __n; ++i)
+                sstl::construct(slots + i, __vals[__idx ? __idx[i] : i]);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            sstl::destroy(slots, slots + i);
+            slot_allocator::deallocate(slots, __n);
+            throw;
+        }
+#endif
+        return slots;
+    }
+
+    static void _free_values(_Value* __slots, size_type __n)
+    {
+        if(__slots) {
+            sstl::destroy(__slots, __slots + __n);
+            slot_allocator::deallocate(__slots, __n);
+        }
+    }
+
+    /**
+     * @brief   Build the table from the __n values in __vals, dropping
+     *          all but the first of the values with equivalent keys
+     */
+    void _build(const _Value* __vals, size_type __n)
+    {
+        const size_type n = __n;
+        vector<size_t, _Alloc> hashes(n, 0);
+        for(size_type i = 0; i < n; ++i)
+            hashes[i] = m_hash(m_getKey(__vals[i]));
+
+        // group the values by bucket with a counting sort
+        const size_type r = n / __bucket_load + 1;
+        m_seeds = vector<_Seed, _Alloc>(r, 0);
+        vector<size_type, _Alloc> start(r + 1, 0);
+        for(size_type i = 0; i < n; ++i)
+            ++start[_bucket(hashes[i]) + 1];
+        for(size_type b = 0; b < r; ++b)
+            start[b + 1] += start[b];
+        vector<size_type, _Alloc> order(n, 0);
+        {
+            vector<size_type, _Alloc> pos(start.begin(), start.end() - 1);
+            for(size_type i = 0; i < n; ++i)
+                order[pos[_bucket(hashes[i])]++] = i;
+        }
+
+        // drop the duplicate keys and move the keys whose hash is
+        // the one of another key to the list, the bucket of each
+        // value is order[start[b], end[b])
+        vector<size_type, _Alloc> end(start.begin() + 1, start.end());
+        vector<size_type, _Alloc> listed;
+        size_type max_size = 0;
+        for(size_type b = 0; b < r; ++b) {
+            size_type last = start[b];
+            for(size_type j = start[b]; j < end[b]; ++j) {
+                const size_type v = order[j];
+                bool keep = true;
+                for(size_type p = start[b]; p < last && keep; ++p) {
+                    const size_type u = order[p];
+                    if(hashes[u] != hashes[v])
+                        continue;
+                    if(!m_equal(m_getKey(__vals[u]), m_getKey(__vals[v]))) {
+                        bool dup = false;
+                        for(size_type q = 0; q < listed.size() && !dup; ++q)
+                            dup = m_equal(m_getKey(__vals[listed[q]]),
+                                          m_getKey(__vals[v]));
+                        if(!dup)
+                            listed.push_back(v);
+                    }
+                    keep = false;
+                }
+                if(keep)
+                    order[last++] = v;
+            }
+            end[b] = last;
+            max_size = sstl::max(max_size, last - start[b]);
+        }
+
+        m_placed = 0;
+        for(size_type b = 0; b < r; ++b)
+            m_placed += end[b] - start[b];
+        const size_type m = m_placed + m_placed / 8 + 1;
+
+        // place the buckets from the largest on, trying seeds until
+        // the keys of the bucket land in distinct free positions,
+        // at[p] is the value at position p or n if there is none
+        vector<size_type, _Alloc> at(m, n);
+        vector<size_type, _Alloc> pos(max_size, 0);
+        vector<size_type, _Alloc> by_size;
+        for(size_type s = max_size; s >= 2; --s)
+            for(size_type b = 0; b < r; ++b)
+                if(end[b] - start[b] == s)
+                    by_size.push_back(b);
+        for(size_type k = 0; k < by_size.size(); ++k) {
+            const size_type b = by_size[k];
+            const size_type s = end[b] - start[b];
+            for(_Seed seed = 0; ; ++seed) {
+                size_type j = 0;
+                for(; j < s; ++j) {
+                    const size_type v = order[start[b] + j];
+                    pos[j] = __frozen_reduce(__frozen_mix(hashes[v], seed), m);
+                    if(at[pos[j]] != n)
+                        break;
+                    at[pos[j]] = v;
+                }
+                if(j == s) {
+                    m_seeds[b] = seed;
+                    break;
+                }
+                while(j > 0)
+                    at[pos[--j]] = n;
+            }
+        }
+
+        // buckets of one key take the holes below m_placed in turn,
+        // and the positions left past it take the remaining holes
+        size_type hole = 0;
+        for(size_type b = 0; b < r; ++b) {
+            if(end[b] - start[b] != 1)
+                continue;
+            while(at[hole] != n)
+                ++hole;
+            at[hole] = order[start[b]];
+            m_seeds[b] = _Seed(hole) | __direct;
+        }
+        m_remap = vector<_Seed, _Alloc>(m - m_placed, 0);
+        for(size_type p = m_placed; p < m; ++p) {
+            if(at[p] == n)
+                continue;
+            while(at[hole] != n)
+                ++hole;
+            at[hole] = at[p];
+            m_remap[p - m_placed] = _Seed(hole);
+        }
+
+        // lay the values out in position order, then the list
+        at.resize(m_placed);
+        for(size_type i = 0; i < listed.size(); ++i)
+            at.push_back(listed[i]);
+        m_slots = _copy_values(__vals, at.begin(), at.size());
+        m_size = at.size();
+    }
+
+    /**
+     * @brief   Copy the values of [__first, __last) aside, then build
+     */
+    template <class _ForwardIter>
+    void _init(_ForwardIter __first, _ForwardIter __last)
+    {
+        size_type n = 0;
+        for(_ForwardIter it = __first; it != __last; ++it)
+            ++n;
+        if(n == 0) {
+            m_seeds = vector<_Seed, _Alloc>(1, 0);
+            return;
+        }
+        _Value* vals = slot_allocator::allocate(n);
+        size_type i = 0;
+        __SSTL_TRY {
+            for(; __first != __last; ++__first, ++i)
+                sstl::construct(vals + i, *__first);
+            _build(vals, n);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            // i values were built, but the block holds n
+            sstl::destroy(vals, vals + i);
+            slot_allocator::deallocate(vals, n);
+            throw;
+        }
+#endif
+        _free_values(vals, n);
+    }
+
+public:
+    /**
+     * @brief   Build the table from the values in [__first, __last),
+     *          keeping the first of the values with equivalent keys
+     */
+    template <class _ForwardIter>
+    frozen_hashtable(_ForwardIter __first, _ForwardIter __last,
+                     const _HashFunc& __hf = _HashFunc(),
+                     const _EqualKey& __eql = _EqualKey())
+     : m_hash(__hf), m_equal(__eql), m_getKey(_ExtractKey()),
+       m_slots(0), m_size(0), m_placed(0), m_seeds(), m_remap()
+    { _init(__first, __last); }
+
+    /**
+     * @brief   Build the table from the values of a table with the
+     *          same hash and key_equal functions, like a hash_set
+     */
+    template <class _Table>
+    explicit frozen_hashtable(const _Table& __t)
+     : m_hash(__t.hash_func()), m_equal(__t.key_eq()),
+       m_getKey(_ExtractKey()), m_slots(0), m_size(0), m_placed(0),
+       m_seeds(), m_remap()
+    { _init(__t.begin(), __t.end()); }
+
+    frozen_hashtable(const frozen_hashtable& __x)
+     : m_hash(__x.m_hash), m_equal(__x.m_equal), m_getKey(__x.m_getKey),
+       m_slots(0), m_size(__x.m_size), m_placed(__x.m_placed),
+       m_seeds(__x.m_seeds), m_remap(__x.m_remap)
+    { m_slots = _copy_values(__x.m_slots, 0, m_size); }
+
+    ~frozen_hashtable() { _free_values(m_slots, m_size); }
+
+    frozen_hashtable& operator=(const frozen_hashtable& __x)
+    {
+        if(this != &__x) {
+            frozen_hashtable tmp(__x);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+    hasher hash_func() const { return m_hash; }
+
+    key_equal key_eq() const { return m_equal; }
+
+    size_type size() const { return m_size; }
+
+    size_type max_size() const { return size_type(-1) / sizeof(_Value); }
+
+    bool empty() const { return m_size == 0; }
+
+    void swap(frozen_hashtable& __x)
+    {
+        sstl::swap(m_hash, __x.m_hash);
+        sstl::swap(m_equal, __x.m_equal);
+        sstl::swap(m_getKey, __x.m_getKey);
+        sstl::swap(m_slots, __x.m_slots);
+        sstl::swap(m_size, __x.m_size);
+        sstl::swap(m_placed, __x.m_placed);
+        m_seeds.swap(__x.m_seeds);
+        m_remap.swap(__x.m_remap);
+    }
+
+    /**
+     * @brief   The values are contiguous, in no particular order
+     */
+    const_iterator begin() const { return m_slots; }
+
+    const_iterator end() const { return m_slots + m_size; }
+
+    const_iterator find(const key_type& __k) const
+    { return m_slots + _find(__k); }
+
+    size_type count(const key_type& __k) const
+    { return _find(__k) == m_size ? 0 : 1; }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    {
+        const_iterator first = find(__k), last = first;
+        if(first != end())
+            ++last;
+        return pair<const_iterator, const_iterator>(first, last);
+    }
+
+    /**
+     * @brief   Return the number of seeds and remapped positions,
+     *          each of which takes 32 bits next to the values
+     */
+    size_type bucket_count() const
+    { return m_seeds.size() + m_remap.size(); }
+
+    friend bool operator==(const frozen_hashtable& __x,
+                           const frozen_hashtable& __y)
+    {
+        if(__x.size() != __y.size())
+            return false;
+        for(const_iterator it = __x.begin(); it != __x.end(); ++it) {
+            const_iterator j = __y.find(__x.m_getKey(*it));
+            if(j == __y.end() || !(*j == *it))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const frozen_hashtable& __x,
+                           const frozen_hashtable& __y)
+    { return !(__x == __y); }
+};
+
+template <class _Key, class _Value, class _HashFunc, class _ExtractKey,
+          class _EqualKey, class _Alloc>
+const typename frozen_hashtable<_Key, _Value, _HashFunc, _ExtractKey,
+                                _EqualKey, _Alloc>::_Seed
+frozen_hashtable<_Key, _Value, _HashFunc, _ExtractKey,
+                 _EqualKey, _Alloc>::__direct;
+
+/**
+ * @brief   Read-only set of keys, see frozen_hashtable
+ */
+template <class _Key,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+using frozen_hash_set = frozen_hashtable<_Key, _Key, _HashFunc,
+        identity<_Key>, _EqualKey, _Alloc>;
+
+/**
+ * @brief   Read-only map of keys to values, see frozen_hashtable
+ */
+template <class _Key,
+          class _Value,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+using frozen_hash_map = frozen_hashtable<_Key, pair<const _Key, _Value>,
+        _HashFunc, select1st<pair<const _Key, _Value> >, _EqualKey, _Alloc>;
+
+} // sstl
+
+
+#endif // SSTL_FROZEN_HASHTABLE_H
@@ -1,6 +1,8 @@
 #ifndef SSTL_FUNCTION_H
 #define SSTL_FUNCTION_H
 
+#include <cstddef>
+#include <cstring>
 
 namespace sstl {
 
@@ -187,7 +189,7 @@ struct logical_not: public unary_function<T, bool> {
 template <class _Tp>
 struct identity
 {
-    _Tp operator()(_Tp x) const { return x; }
+    const _Tp& operator()(const _Tp& x) const { return x; }
 };
 
 template <class T>
@@ -240,6 +242,63 @@ struct project2nd: public binary_function<Arg1, Arg2, Arg2> {
     { return y; }
 };
 
+inline const char* __str_data(const char* x) { return x; }
+
+inline size_t __str_size(const char* x) { return strlen(x); }
+
+template <class Str>
+inline const char* __str_data(const Str& x) { return x.data(); }
+
+template <class Str>
+inline size_t __str_size(const Str& x) { return x.size(); }
+
+/**
+ * @brief   Hash the characters of a string, which may be a
+ *          std::string, a C string or any view with data() and
+ *          size(). Equal characters give equal hashes whatever
+ *          the type, so with string_equal_to a hashtable of
+ *          strings can be probed without building a string
+ */
+struct string_hash {
+    typedef void is_transparent;
+
+    template <class Str>
+    size_t operator()(const Str& x) const
+    {
+        // FNV-1a
+        const unsigned char* p = (const unsigned char*)__str_data(x);
+        const size_t n = __str_size(x);
+#if __SIZEOF_SIZE_T__ == 8
+        const size_t prime = 1099511628211ull;
+        size_t h = 14695981039346656037ull;
+#else
+        const size_t prime = 16777619u;
+        size_t h = 2166136261u;
+#endif
+        for(size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= prime;
+        }
+        return h;
+    }
+};
+
+/**
+ * @brief   Compare the characters of two strings of
+ *          any of the types accepted by string_hash
+ */
+struct string_equal_to {
+    typedef void is_transparent;
+
+    template <class Str1, class Str2>
+    bool operator()(const Str1& x, const Str2& y) const
+    {
+        const size_t n = __str_size(x);
+        return n == __str_size(y) &&
+               memcmp(__str_data(x), __str_data(y), n) == 0;
+    }
+};
+
 } // sstl
 
 
@@ -0,0 +1,603 @@
+#ifndef SSTL_HASH_MAP_H
+#define SSTL_HASH_MAP_H
+
+#include "sstl_hashtable.h"
+#include "sstl_functional.h"
+#include "sstl_pair.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Map of unique keys to values kept in a hashtable.
+ *          With transparent hash and key_equal functions, like
+ *          string_hash and string_equal_to, find, count and
+ *          equal_range accept any key like type without building
+ *          a key_type
+ */
+template <class _Key,
+          class _Value,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class hash_map {
+private:
+    typedef hashtable<_Key, pair<const _Key, _Value>, _HashFunc,
+                      select1st<pair<const _Key, _Value> >,
+                      _EqualKey, _Alloc> _Ht;
+    _Ht m_ht;
+
+public:
+    typedef typename _Ht::key_type    key_type;
+    typedef _Value                    mapped_type;
+    typedef typename _Ht::value_type  value_type;
+    typedef typename _Ht::hasher      hasher;
+    typedef typename _Ht::key_equal   key_equal;
+
+    typedef typename _Ht::size_type       size_type;
+    typedef typename _Ht::difference_type difference_type;
+    typedef typename _Ht::pointer         pointer;
+    typedef typename _Ht::reference       reference;
+
+    typedef typename _Ht::const_pointer   const_pointer;
+    typedef typename _Ht::const_reference const_reference;
+
+    typedef typename _Ht::iterator        iterator;
+    typedef typename _Ht::const_iterator  const_iterator;
+
+    typedef typename _Ht::allocator_type  allocator_type;
+
+    /**
+     * @brief   Return the function that hashes the keys
+     */
+    hasher hash_func() const { return m_ht.hash_func(); }
+
+    /**
+     * @brief   Return the function that compares keys
+     *          for equality
+     */
+    key_equal key_eq() const { return m_ht.key_eq(); }
+
+    /**
+     * @brief   Return the allocator associated with the container
+     */
+    allocator_type get_allocator() const
+    { return m_ht.get_allocator(); }
+
+public:
+    hash_map(): m_ht(100, hasher(), key_equal()) {}
+
+    explicit hash_map(size_type __n)
+     : m_ht(__n, hasher(), key_equal()) {}
+
+    hash_map(const size_type __n, const hasher& __hf)
+     : m_ht(__n, __hf, key_equal()) {}
+
+    hash_map(const size_type __n, const hasher& __hf,
+             const key_equal& __eql)
+     : m_ht(__n, __hf, __eql) {}
+
+    template <class InputIter>
+    hash_map(InputIter __first, InputIter __last)
+     : m_ht(100, hasher(), key_equal())
+    { m_ht.insert_unique(__first, __last); }
+
+    /**
+     * @brief   Return the number of elements
+     */
+    size_type size() const { return m_ht.size(); }
+
+    /**
+     * @brief   Return the maximum possible number of elements
+     */
+    size_type max_size() const { return m_ht.max_size(); }
+
+    /**
+     * @brief   Check whether the map is empty
+     */
+    bool empty() const { return m_ht.empty(); }
+
+    /**
+     * @brief   Exchange the content of container with other
+     */
+    void swap(hash_map& __hm) { m_ht.swap(__hm.m_ht); }
+
+    friend inline bool operator==(const hash_map& __hm1,
+                                  const hash_map& __hm2)
+    { return __hm1.m_ht == __hm2.m_ht; }
+
+    friend inline bool operator!=(const hash_map& __hm1,
+                                  const hash_map& __hm2)
+    { return !(__hm1 == __hm2); }
+
+    /**
+     * @brief   Return an iterator to the beginning
+     */
+    iterator begin() { return m_ht.begin(); }
+
+    const_iterator begin() const { return m_ht.begin(); }
+
+    /**
+     * @brief   Return an iterator to the end
+     */
+    iterator end() { return m_ht.end(); }
+
+    const_iterator end() const { return m_ht.end(); }
+
+    /**
+     * @brief   Insert element into the container
+     * @param   __val: element value to insert
+     */
+    pair<iterator, bool> insert(const value_type& __val)
+    { return m_ht.insert_unique(__val); }
+
+    /**
+     * @brief   Insert element(s) into the container
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class InputIter>
+    void insert(InputIter __first, InputIter __last)
+    { m_ht.insert_unique(__first, __last); }
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Insert the elements of a random access range on the
+     *          threads set by parallel_threads
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class RandomIter>
+    void insert_parallel(RandomIter __first, RandomIter __last)
+    { m_ht.insert_unique_parallel(__first, __last); }
+#endif
+
+    /**
+     * @brief   Return the value mapped to __k, inserting a
+     *          default constructed value if there is none
+     */
+    mapped_type& operator[](const key_type& __k)
+    {
+        iterator it = m_ht.find(__k);
+        if(it == m_ht.end())
+            it = m_ht.insert_unique(value_type(__k, mapped_type())).first;
+        return it->second;
+    }
+
+    /**
+     * @brief   Find an element with key equivalent to key
+     * @param   __k: key value of the element to search for
+     */
+    iterator find(const key_type& __k) { return m_ht.find(__k); }
+
+    const_iterator find(const key_type& __k) const
+    { return m_ht.find(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, iterator, _Kt>::type
+    find(const _Kt& __k) { return m_ht.find(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, const_iterator, _Kt>::type
+    find(const _Kt& __k) const { return m_ht.find(__k); }
+
+    /**
+     * @brief   Return the number of elements with key
+     * @param   __k: key value of the elements to count
+     */
+    size_type count(const key_type& __k) const
+    { return m_ht.count(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, size_type, _Kt>::type
+    count(const _Kt& __k) const { return m_ht.count(__k); }
+
+    /**
+     * @brief   Return a range containing all elements with
+     *          the given key in the container
+     * @param   __k: key value to compare the elements
+     */
+    pair<iterator, iterator> equal_range(const key_type& __k)
+    { return m_ht.equal_range(__k); }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    { return m_ht.equal_range(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey,
+                                pair<iterator, iterator>, _Kt>::type
+    equal_range(const _Kt& __k) { return m_ht.equal_range(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey,
+            pair<const_iterator, const_iterator>, _Kt>::type
+    equal_range(const _Kt& __k) const { return m_ht.equal_range(__k); }
+
+    /**
+     * @brief   Remove the element with key equivalent to __k
+     * @param   __k: key value of the elements to remove
+     */
+    size_type erase(const key_type& __k)
+    { return m_ht.erase(__k); }
+
+    /**
+     * @brief   Remove the element at certain position
+     * @param   __it: iterator to the element to remove
+     */
+    void erase(const_iterator __it) { m_ht.erase(__it); }
+
+    /**
+     * @brief   Remove the element in the range[first, last)
+     * @param   __first, __last: range of elements to remove
+     */
+    void erase(const_iterator __first, const_iterator __last)
+    { m_ht.erase(__first, __last); }
+
+    /**
+     * @brief   Erase all elements from the container
+     */
+    void clear() { m_ht.clear(); }
+
+    /**
+     * @brief   Resize the container to certain size
+     * @param   __hint_n: new size of the container
+     */
+    void resize(size_type __hint_n)
+    { m_ht.resize(__hint_n); }
+
+    /**
+     * @brief   Return the average number of elements per bucket
+     */
+    float load_factor() const { return m_ht.load_factor(); }
+
+    /**
+     * @brief   Return the load factor past which inserting grows
+     *          the buckets
+     */
+    float max_load_factor() const { return m_ht.max_load_factor(); }
+
+    /**
+     * @brief   Set the load factor past which inserting grows
+     *          the buckets
+     */
+    void max_load_factor(float __z) { m_ht.max_load_factor(__z); }
+
+    /**
+     * @brief   Grow the buckets so that __n elements can be inserted
+     *          without rehashing
+     */
+    void reserve(size_type __n) { m_ht.reserve(__n); }
+
+    /**
+     * @brief   Set the number of buckets to at least __n, growing
+     *          or shrinking them
+     */
+    void rehash(size_type __n) { m_ht.rehash(__n); }
+
+    /**
+     * @brief   Shrink the buckets to the fewest that hold the
+     *          elements
+     */
+    void shrink_to_fit() { m_ht.shrink_to_fit(); }
+
+    /**
+     * @brief   Spread rehashing over the following operations
+     *          instead of moving every element at once
+     */
+    void incremental_rehash(bool __on)
+    { m_ht.incremental_rehash(__on); }
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Set the number of threads rehashing large tables and
+     *          running insert_parallel
+     */
+    void parallel_threads(unsigned __n) { m_ht.parallel_threads(__n); }
+#endif
+
+    /**
+     * @brief   Return the number of buckets
+     */
+    size_type bucket_count() const
+    { return m_ht.bucket_count(); }
+
+    /**
+     * @brief   Return the maximum number of buckets
+     */
+    size_type max_bucket_count() const
+    { return m_ht.max_bucket_count(); }
+
+    /**
+     * @brief   Return the number of elements in the
+     *          bucket with index __n
+     * @param   __n: the index of bucket to examine
+     */
+    size_type elems_in_bucket(size_type __n) const
+    { return m_ht.elems_in_bucket(__n); }
+};
+
+/**
+ * @brief   Map of keys to values kept in a hashtable, where
+ *          several elements may have equivalent keys. Elements
+ *          with equivalent keys are adjacent in iteration order
+ */
+template <class _Key,
+          class _Value,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class hash_multimap {
+private:
+    typedef hashtable<_Key, pair<const _Key, _Value>, _HashFunc,
+                      select1st<pair<const _Key, _Value> >,
+                      _EqualKey, _Alloc> _Ht;
+    _Ht m_ht;
+
+public:
+    typedef typename _Ht::key_type    key_type;
+    typedef _Value                    mapped_type;
+    typedef typename _Ht::value_type  value_type;
+    typedef typename _Ht::hasher      hasher;
+    typedef typename _Ht::key_equal   key_equal;
+
+    typedef typename _Ht::size_type       size_type;
+    typedef typename _Ht::difference_type difference_type;
+    typedef typename _Ht::pointer         pointer;
+    typedef typename _Ht::reference       reference;
+
+    typedef typename _Ht::const_pointer   const_pointer;
+    typedef typename _Ht::const_reference const_reference;
+
+    typedef typename _Ht::iterator        iterator;
+    typedef typename _Ht::const_iterator  const_iterator;
+
+    typedef typename _Ht::allocator_type  allocator_type;
+
+    /**
+     * @brief   Return the function that hashes the keys
+     */
+    hasher hash_func() const { return m_ht.hash_func(); }
+
+    /**
+     * @brief   Return the function that compares keys
+     *          for equality
+     */
+    key_equal key_eq() const { return m_ht.key_eq(); }
+
+    /**
+     * @brief   Return the allocator associated with the container
+     */
+    allocator_type get_allocator() const
+    { return m_ht.get_allocator(); }
+
+public:
+    hash_multimap(): m_ht(100, hasher(), key_equal()) {}
+
+    explicit hash_multimap(size_type __n)
+     : m_ht(__n, hasher(), key_equal()) {}
+
+    hash_multimap(const size_type __n, const hasher& __hf)
+     : m_ht(__n, __hf, key_equal()) {}
+
+    hash_multimap(const size_type __n, const hasher& __hf,
+                  const key_equal& __eql)
+     : m_ht(__n, __hf, __eql) {}
+
+    template <class InputIter>
+    hash_multimap(InputIter __first, InputIter __last)
+     : m_ht(100, hasher(), key_equal())
+    { m_ht.insert_equal(__first, __last); }
+
+    /**
+     * @brief   Return the number of elements
+     */
+    size_type size() const { return m_ht.size(); }
+
+    /**
+     * @brief   Return the maximum possible number of elements
+     */
+    size_type max_size() const { return m_ht.max_size(); }
+
+    /**
+     * @brief   Check whether the map is empty
+     */
+    bool empty() const { return m_ht.empty(); }
+
+    /**
+     * @brief   Exchange the content of container with other
+     */
+    void swap(hash_multimap& __hm) { m_ht.swap(__hm.m_ht); }
+
+    friend inline bool operator==(const hash_multimap& __hm1,
+                                  const hash_multimap& __hm2)
+    { return __hm1.m_ht == __hm2.m_ht; }
+
+    friend inline bool operator!=(const hash_multimap& __hm1,
+                                  const hash_multimap& __hm2)
+    { return !(__hm1 == __hm2); }
+
+    /**
+     * @brief   Return an iterator to the beginning
+     */
+    iterator begin() { return m_ht.begin(); }
+
+    const_iterator begin() const { return m_ht.begin(); }
+
+    /**
+     * @brief   Return an iterator to the end
+     */
+    iterator end() { return m_ht.end(); }
+
+    const_iterator end() const { return m_ht.end(); }
+
+    /**
+     * @brief   Insert element into the container, next to
+     *          the elements with an equivalent key if any
+     * @param   __val: element value to insert
+     */
+    iterator insert(const value_type& __val)
+    { return m_ht.insert_equal(__val); }
+
+    /**
+     * @brief   Insert element(s) into the container
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class InputIter>
+    void insert(InputIter __first, InputIter __last)
+    { m_ht.insert_equal(__first, __last); }
+
+    /**
+     * @brief   Find an element with key equivalent to key
+     * @param   __k: key value of the element to search for
+     */
+    iterator find(const key_type& __k) { return m_ht.find(__k); }
+
+    const_iterator find(const key_type& __k) const
+    { return m_ht.find(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, iterator, _Kt>::type
+    find(const _Kt& __k) { return m_ht.find(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, const_iterator, _Kt>::type
+    find(const _Kt& __k) const { return m_ht.find(__k); }
+
+    /**
+     * @brief   Return the number of elements with key
+     * @param   __k: key value of the elements to count
+     */
+    size_type count(const key_type& __k) const
+    { return m_ht.count(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, size_type, _Kt>::type
+    count(const _Kt& __k) const { return m_ht.count(__k); }
+
+    /**
+     * @brief   Return a range containing all elements with
+     *          the given key in the container
+     * @param   __k: key value to compare the elements
+     */
+    pair<iterator, iterator> equal_range(const key_type& __k)
+    { return m_ht.equal_range(__k); }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    { return m_ht.equal_range(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey,
+                                pair<iterator, iterator>, _Kt>::type
+    equal_range(const _Kt& __k) { return m_ht.equal_range(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey,
+            pair<const_iterator, const_iterator>, _Kt>::type
+    equal_range(const _Kt& __k) const { return m_ht.equal_range(__k); }
+
+    /**
+     * @brief   Remove all the elements with key equivalent to __k
+     * @param   __k: key value of the elements to remove
+     */
+    size_type erase(const key_type& __k)
+    { return m_ht.erase(__k); }
+
+    /**
+     * @brief   Remove the element at certain position
+     * @param   __it: iterator to the element to remove
+     */
+    void erase(const_iterator __it) { m_ht.erase(__it); }
+
+    /**
+     * @brief   Remove the element in the range[first, last)
+     * @param   __first, __last: range of elements to remove
+     */
+    void erase(const_iterator __first, const_iterator __last)
+    { m_ht.erase(__first, __last); }
+
+    /**
+     * @brief   Erase all elements from the container
+     */
+    void clear() { m_ht.clear(); }
+
+    /**
+     * @brief   Resize the container to certain size
+     * @param   __hint_n: new size of the container
+     */
+    void resize(size_type __hint_n)
+    { m_ht.resize(__hint_n); }
+
+    /**
+     * @brief   Return the average number of elements per bucket
+     */
+    float load_factor() const { return m_ht.load_factor(); }
+
+    /**
+     * @brief   Return the load factor past which inserting grows
+     *          the buckets
+     */
+    float max_load_factor() const { return m_ht.max_load_factor(); }
+
+    /**
+     * @brief   Set the load factor past which inserting grows
+     *          the buckets
+     */
+    void max_load_factor(float __z) { m_ht.max_load_factor(__z); }
+
+    /**
+     * @brief   Grow the buckets so that __n elements can be inserted
+     *          without rehashing
+     */
+    void reserve(size_type __n) { m_ht.reserve(__n); }
+
+    /**
+     * @brief   Set the number of buckets to at least __n, growing
+     *          or shrinking them
+     */
+    void rehash(size_type __n) { m_ht.rehash(__n); }
+
+    /**
+     * @brief   Shrink the buckets to the fewest that hold the
+     *          elements
+     */
+    void shrink_to_fit() { m_ht.shrink_to_fit(); }
+
+    /**
+     * @brief   Spread rehashing over the following operations
+     *          instead of moving every element at once
+     */
+    void incremental_rehash(bool __on)
+    { m_ht.incremental_rehash(__on); }
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Set the number of threads rehashing large tables
+     */
+    void parallel_threads(unsigned __n) { m_ht.parallel_threads(__n); }
+#endif
+
+    /**
+     * @brief   Return the number of buckets
+     */
+    size_type bucket_count() const
+    { return m_ht.bucket_count(); }
+
+    /**
+     * @brief   Return the maximum number of buckets
+     */
+    size_type max_bucket_count() const
+    { return m_ht.max_bucket_count(); }
+
+    /**
+     * @brief   Return the number of elements in the
+     *          bucket with index __n
+     * @param   __n: the index of bucket to examine
+     */
+    size_type elems_in_bucket(size_type __n) const
+    { return m_ht.elems_in_bucket(__n); }
+};
+
+} // sstl
+
+
+#endif // SSTL_HASH_MAP_H
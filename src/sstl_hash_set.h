@@ -2,21 +2,30 @@
 #define SSTL_HASH_SET_H
 
 #include "sstl_hashtable.h"
+#include "sstl_flat_hashtable.h"
+#include "sstl_robin_hashtable.h"
 #include "sstl_pair.h"
 
 
 namespace sstl {
 
+/**
+ * @brief   Set of unique keys kept in a hashtable. _Table is the
+ *          table holding the elements, the chained hashtable by
+ *          default, flat_hashtable or robin_hashtable, see
+ *          flat_hash_set and robin_hash_set
+ */
 template <class _Key,
           class _Value,
           class _HashFunc = std::hash<_Key>,
           class _EqualKey = sstl::equal_to<_Key>,
-          class _Alloc = __SSTL_DEFAULT_ALLOC>
+          class _Alloc = __SSTL_DEFAULT_ALLOC,
+          class _Table = hashtable<_Key, _Value, _HashFunc,
+                                   identity<_Value>, _EqualKey,
+                                   _Alloc> >
 class hash_set {
 private:
-    typedef hashtable<_Key, _Value, _HashFunc,
-                      identity<_Value>, _EqualKey,
-                      _Alloc> _Ht;
+    typedef _Table _Ht;
     _Ht m_ht;
 
 public:
@@ -100,7 +109,7 @@ public:
     /**
      * @brief   Return an iterator to the end
      */
-    iterator end() const { return m_ht.begin(); }
+    iterator end() const { return m_ht.end(); }
 
     /**
      * @brief   Insert element into the container
@@ -121,6 +130,18 @@ public:
     void insert(InputIter __first, InputIter __last)
     { m_ht.insert_unique(__first, __last); }
 
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Insert the elements of a random access range on the
+     *          threads set by parallel_threads. Only for the chained
+     *          hashtable
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class RandomIter>
+    void insert_parallel(RandomIter __first, RandomIter __last)
+    { m_ht.insert_unique_parallel(__first, __last); }
+#endif
+
     /**
      * @brief   Find an element with key equivalent to key
      * @param   __k: key value of the element to search for
@@ -135,6 +156,23 @@ public:
     size_type count(const key_type& __k) const
     { return m_ht.count(__k); }
 
+    /**
+     * @brief   Find each of the keys __keys[0, __n) into __out[i],
+     *          overlapping the cache misses of the lookups. Only
+     *          for the chained hashtable
+     */
+    void find_batch(const key_type* __keys, size_type __n,
+                    iterator* __out) const
+    { m_ht.find_batch(__keys, __n, __out); }
+
+    /**
+     * @brief   Count each of the keys __keys[0, __n) into __out[i],
+     *          see find_batch
+     */
+    void count_batch(const key_type* __keys, size_type __n,
+                     size_type* __out) const
+    { m_ht.count_batch(__keys, __n, __out); }
+
     /**
      * @brief   Return a range containing all elements with
      *          the given key in the container
@@ -176,6 +214,58 @@ public:
     void resize(size_type __hint_n)
     { m_ht.resize(__hint_n); }
 
+    /**
+     * @brief   Return the average number of elements per bucket,
+     *          only for the chained hashtable
+     */
+    float load_factor() const { return m_ht.load_factor(); }
+
+    /**
+     * @brief   Return the load factor past which inserting grows
+     *          the buckets. Only for the chained hashtable
+     */
+    float max_load_factor() const { return m_ht.max_load_factor(); }
+
+    /**
+     * @brief   Set the load factor past which inserting grows
+     *          the buckets. Only for the chained hashtable
+     */
+    void max_load_factor(float __z) { m_ht.max_load_factor(__z); }
+
+    /**
+     * @brief   Grow the buckets so that __n elements can be inserted
+     *          without rehashing. Only for the chained hashtable
+     */
+    void reserve(size_type __n) { m_ht.reserve(__n); }
+
+    /**
+     * @brief   Set the number of buckets to at least __n, growing
+     *          or shrinking them. Only for the chained hashtable
+     */
+    void rehash(size_type __n) { m_ht.rehash(__n); }
+
+    /**
+     * @brief   Shrink the buckets to the fewest that hold the
+     *          elements. Only for the chained hashtable
+     */
+    void shrink_to_fit() { m_ht.shrink_to_fit(); }
+
+    /**
+     * @brief   Spread rehashing over the following operations instead
+     *          of moving every element at once, only for the chained
+     *          hashtable
+     */
+    void incremental_rehash(bool __on)
+    { m_ht.incremental_rehash(__on); }
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Set the number of threads rehashing large tables and
+     *          running insert_parallel. Only for the chained hashtable
+     */
+    void parallel_threads(unsigned __n) { m_ht.parallel_threads(__n); }
+#endif
+
     /**
      * @brief   Return the number of buckets
      */
@@ -197,6 +287,32 @@ public:
     { return m_ht.elems_in_bucket(__n); }
 };
 
+/**
+ * @brief   hash_set over flat_hashtable, which keeps the elements
+ *          inline in open addressed slots. Inserting or erasing may
+ *          invalidate all iterators
+ */
+template <class _Key,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+using flat_hash_set = hash_set<_Key, _Key, _HashFunc, _EqualKey, _Alloc,
+        flat_hashtable<_Key, _Key, _HashFunc, identity<_Key>,
+                       _EqualKey, _Alloc> >;
+
+/**
+ * @brief   hash_set over robin_hashtable, which keeps missed
+ *          lookups short at high load factors. Inserting or
+ *          erasing may invalidate all iterators
+ */
+template <class _Key,
+          class _HashFunc = std::hash<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+using robin_hash_set = hash_set<_Key, _Key, _HashFunc, _EqualKey, _Alloc,
+        robin_hashtable<_Key, _Key, _HashFunc, identity<_Key>,
+                        _EqualKey, _Alloc> >;
+
 } // sstl
 
 
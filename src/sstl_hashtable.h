@@ -4,43 +4,238 @@
 #include "sstl_functional.h"
 #include "sstl_iterator.h"
 #include "sstl_alloc.h"
+#include "sstl_algo.h"
 #include "sstl_vector.h"
 #include "sstl_config.h"
+#include "sstl_traits.h"
 #include "sstl_pair.h"
+#include <stdexcept>
+#ifdef __SSTL_HASHTABLE_PARALLEL
+#include <exception>
+#include <thread>
+#endif
 
 
 namespace sstl {
 
-template <class _Value>
+/**
+ * @brief   Spread the bits of a hash value over the whole word,
+ *          so that tables which use only some of the bits work
+ *          with weak hashes like the identity std::hash<int>
+ */
+inline size_t __hash_mix(size_t __h)
+{
+#if __SIZEOF_SIZE_T__ == 8
+    __h ^= __h >> 33;
+    __h *= 0xff51afd7ed558ccdull;
+    __h ^= __h >> 33;
+#else
+    __h ^= __h >> 16;
+    __h *= 0x85ebca6bu;
+    __h ^= __h >> 13;
+#endif
+    return __h;
+}
+
+/**
+ * @brief   Mix all bits of __h into all others, the murmur3
+ *          finalizer. Slower than __hash_mix, for users which
+ *          need every bit of the result to be uniform
+ */
+inline size_t __hash_fmix(size_t __h)
+{
+#if __SIZEOF_SIZE_T__ == 8
+    __h ^= __h >> 33;
+    __h *= 0xff51afd7ed558ccdull;
+    __h ^= __h >> 33;
+    __h *= 0xc4ceb9fe1a85ec53ull;
+    __h ^= __h >> 33;
+#else
+    __h ^= __h >> 16;
+    __h *= 0x85ebca6bu;
+    __h ^= __h >> 13;
+    __h *= 0xc2b2ae35u;
+    __h ^= __h >> 16;
+#endif
+    return __h;
+}
+
+/**
+ * @brief   Bucket counts taken from a list of primes, the hash
+ *          value modulo the bucket count is the bucket index.
+ *          The modulo spreads weak hashes, but costs a division
+ */
+template <bool __dummy>
+class __prime_bucket_policy_template {
+private:
+    enum { __num_primes = 28 };
+
+    static const unsigned long __prime_list[__num_primes];
+
+public:
+    /**
+     * @brief   Return the smallest bucket count not less than __n
+     */
+    static size_t next_size(size_t __n)
+    {
+        const unsigned long* first = __prime_list;
+        const unsigned long* last = __prime_list + __num_primes;
+        const unsigned long* pos = sstl::lower_bound(first, last, (unsigned long)__n);
+        return pos == last ? *(last - 1) : *pos;
+    }
+
+    static size_t max_size() { return __prime_list[__num_primes - 1]; }
+
+    static size_t index(size_t __hash, size_t __n) { return __hash % __n; }
+};
+
+template <bool __dummy>
+const unsigned long
+__prime_bucket_policy_template<__dummy>::__prime_list[__num_primes] =
+{
+        53ul,         97ul,         193ul,       389ul,       769ul,
+        1543ul,       3079ul,       6151ul,      12289ul,     24593ul,
+        49157ul,      98317ul,      196613ul,    393241ul,    786433ul,
+        1572869ul,    3145739ul,    6291469ul,   12582917ul,  25165843ul,
+        50331653ul,   100663319ul,  201326611ul, 402653189ul, 805306457ul,
+        1610612741ul, 3221225473ul, 4294967291ul
+};
+
+typedef __prime_bucket_policy_template<true> __prime_bucket_policy;
+
+/**
+ * @brief   Power of two bucket counts, the low bits of the mixed
+ *          hash value are the bucket index. A mask and a multiply
+ *          replace the division of __prime_bucket_policy
+ */
+struct __pow2_bucket_policy {
+    static size_t next_size(size_t __n)
+    {
+        size_t n = 8;
+        while(n < __n && n < max_size())
+            n <<= 1;
+        return n;
+    }
+
+    static size_t max_size() { return (size_t(-1) >> 1) + 1; }
+
+    static size_t index(size_t __hash, size_t __n)
+    { return __hash_mix(__hash) & (__n - 1); }
+};
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+enum { __max_threads = 64 };
+
+/**
+ * @brief   Call __f(i) for each i in [0, __n) on __n threads, the
+ *          calling one running __f(0), and wait for all of them.
+ *          __f must not throw. If a thread can't be started, its
+ *          part runs on the calling thread afterwards
+ */
+template <class _Func>
+void __parallel_run(unsigned __n, _Func& __f)
+{
+    std::thread workers[__max_threads];
+    bool started[__max_threads] = { false };
+    for(unsigned i = 1; i < __n; ++i) {
+        __SSTL_TRY {
+            workers[i] = std::thread([&__f, i]() { __f(i); });
+            started[i] = true;
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {}
+#endif
+    }
+    __f(0);
+    for(unsigned i = 1; i < __n; ++i) {
+        if(started[i])
+            workers[i].join();
+        else
+            __f(i);
+    }
+}
+#endif
+
+template <class _IsPOD>
+struct __hashtable_cache_hash_aux { typedef __true_type type; };
+
+template <>
+struct __hashtable_cache_hash_aux<__true_type> { typedef __false_type type; };
+
+/**
+ * @brief   Whether the nodes of a hashtable with keys of type _Key
+ *          keep the hash values of their keys, __true_type or
+ *          __false_type. Hashing and comparing POD keys is cheap,
+ *          so only other keys, like strings, keep the hash. It can
+ *          be specialized for a key type to choose otherwise
+ */
+template <class _Key>
+struct __hashtable_cache_hash:
+    public __hashtable_cache_hash_aux<typename __type_traits<_Key>::is_POD_type> {};
+
+/**
+ * @brief   Member type is _Tp when both _HashFunc and _EqualKey
+ *          declare is_transparent, so that lookups taking any key
+ *          like type _Kt drop out of overload resolution otherwise
+ */
+template <class _HashFunc, class _EqualKey, class _Tp, class _Kt,
+          class = void>
+struct __hash_transparent {};
+
+template <class _Tp1, class _Tp2>
+struct __hash_void { typedef void type; };
+
+template <class _HashFunc, class _EqualKey, class _Tp, class _Kt>
+struct __hash_transparent<_HashFunc, _EqualKey, _Tp, _Kt,
+        typename __hash_void<typename _HashFunc::is_transparent,
+                             typename _EqualKey::is_transparent>::type>
+{ typedef _Tp type; };
+
+template <class _Value, class _CacheHash = __false_type>
 struct __hashtable_node {
     __hashtable_node* next;
     _Value data;
 };
 
+/**
+ * @brief   Node keeping the hash value of its key, so that
+ *          rehashing doesn't call the hash function and most
+ *          keys which differ are told apart without comparing
+ */
+template <class _Value>
+struct __hashtable_node<_Value, __true_type> {
+    __hashtable_node* next;
+    size_t hash;
+    _Value data;
+};
+
 template <class _Key, class _Value,
           class _HashFunc, // type of hash function
           class _ExtractKey, // function of getting key from value
           class _EqualKey, // function of checking if the arguments are equal
-          class _Alloc> //
+          class _Alloc,
+          class _BucketPolicy> // mapping of hash values to buckets
 class hashtable;
 
 template <class _Key, class _Value,
           class _HashFunc,
           class _ExtractKey,
           class _EqualKey,
-          class _Alloc>
-struct __hashtable_const_iterator;
+          class _Alloc,
+          class _BucketPolicy>
+class __hashtable_const_iterator;
 
 template <class _Key, class _Value,
           class _HashFunc,
           class _ExtractKey,
           class _EqualKey,
-          class _Alloc>
+          class _Alloc,
+          class _BucketPolicy>
 class __hashtable_iterator {
 public:
-    typedef hashtable<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> hashtable;
-    typedef __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> iterator;
-    typedef __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> const_iterator;
+    typedef hashtable<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> _Hashtable;
+    typedef __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> iterator;
+    typedef __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> const_iterator;
 
     typedef _Value value_type;
     typedef _Value& reference;
@@ -51,14 +246,18 @@ public:
     typedef forward_iterator_tag iterator_category;
 
 private:
-    typedef __hashtable_node<_Value>* _Link_type;
+    typedef typename __hashtable_cache_hash<_Key>::type _CacheHash;
+    typedef __hashtable_node<_Value, _CacheHash>* _Link_type;
+
+    friend class hashtable<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy>;
+    friend class __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy>;
 
 private:
     _Link_type m_cur;
-    hashtable* m_ht;
+    _Hashtable* m_ht;
 
 public:
-    __hashtable_iterator(_Link_type __cur, hashtable* __ht)
+    __hashtable_iterator(_Link_type __cur, _Hashtable* __ht)
      : m_cur(__cur), m_ht(__ht) {}
 
     __hashtable_iterator() = default;
@@ -72,17 +271,11 @@ public:
 
     iterator& operator++()
     {
-        const iterator old = m_cur;
-        m_cur = m_cur->next;
-        if(!m_cur) {
-            size_t bucket = m_ht->bkt_num(old->data);
-            while(!m_cur && ++bucket < m_ht->m_buckets.size())
-                m_cur = m_ht->m_buckets[bucket];
-        }
+        m_cur = m_ht->_next_node(m_cur);
         return *this;
     }
 
-    const const_iterator operator++(int)
+    const iterator operator++(int)
     {
         iterator tmp = *this;
         ++*this;
@@ -100,31 +293,35 @@ template <class _Key, class _Value,
           class _HashFunc,
           class _ExtractKey,
           class _EqualKey,
-          class _Alloc>
+          class _Alloc,
+          class _BucketPolicy>
 class __hashtable_const_iterator {
 public:
-    typedef hashtable<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> hashtable;
-    typedef __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> iterator;
-    typedef __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> const_iterator;
+    typedef hashtable<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> _Hashtable;
+    typedef __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> iterator;
+    typedef __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> const_iterator;
 
     typedef _Value value_type;
     typedef ptrdiff_t difference_type;
-    typedef _Value& reference;
-    typedef _Value* pointer;
+    typedef const _Value& reference;
+    typedef const _Value* pointer;
 
     typedef forward_iterator_tag iterator_category;
 
 private:
-    typedef __hashtable_node<_Value>* _Link_type;
+    typedef typename __hashtable_cache_hash<_Key>::type _CacheHash;
+    typedef __hashtable_node<_Value, _CacheHash>* _Link_type;
+
+    friend class hashtable<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy>;
 
 private:
     _Link_type m_cur;
-    hashtable* m_ht;
+    const _Hashtable* m_ht;
 
 public:
     __hashtable_const_iterator(): m_cur(0), m_ht(0) {}
 
-    __hashtable_const_iterator(_Link_type __cur, hashtable* __ht)
+    __hashtable_const_iterator(_Link_type __cur, const _Hashtable* __ht)
      : m_cur(__cur), m_ht(__ht) {}
 
     __hashtable_const_iterator(const iterator& __it)
@@ -136,13 +333,7 @@ public:
 
     const_iterator& operator++()
     {
-        _Link_type old = m_cur;
-        m_cur = m_cur->next;
-        if(!m_cur) {
-            size_t bucket = m_ht->bkt_num(old->data);
-            while(!m_cur && ++bucket < m_ht->m_buckets.size())
-                m_cur = m_ht->m_buckets[bucket];
-        }
+        m_cur = m_ht->_next_node(m_cur);
         return *this;
     }
 
@@ -153,10 +344,10 @@ public:
         return tmp;
     }
 
-    bool operator==(const const_iterator& __it)
+    bool operator==(const const_iterator& __it) const
     { return m_cur == __it.m_cur; }
 
-    bool operator!=(const const_iterator& __it)
+    bool operator!=(const const_iterator& __it) const
     { return m_cur != __it.m_cur; }
 };
 
@@ -164,7 +355,8 @@ template <class _Key, class _Value,
           class _HashFunc = std::hash<_Key>, // type of hash function
           class _ExtractKey = sstl::identity<_Key>, // function of getting key from value
           class _EqualKey = sstl::equal_to<_Key>, // function of checking if the arguments are equal
-          class _Alloc = __SSTL_DEFAULT_ALLOC>
+          class _Alloc = __SSTL_DEFAULT_ALLOC,
+          class _BucketPolicy = __pow2_bucket_policy>
 class hashtable {
 public:
     typedef _Key key_type;
@@ -177,15 +369,21 @@ public:
     typedef _Value& reference;
     typedef const _Value& const_reference;
 
-    typedef __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> iterator;
-    typedef __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc> const_iterator;
+    typedef __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> iterator;
+    typedef __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy> const_iterator;
 
     typedef _HashFunc hasher;
     typedef _EqualKey key_equal;
 
+    typedef _Alloc allocator_type;
+
+    friend class __hashtable_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy>;
+    friend class __hashtable_const_iterator<_Key, _Value, _HashFunc, _ExtractKey, _EqualKey, _Alloc, _BucketPolicy>;
+
 private:
-    typedef __hashtable_node<_Value> _Node;
-    typedef __hashtable_node<_Value>* _Link_type;
+    typedef typename __hashtable_cache_hash<_Key>::type _CacheHash;
+    typedef __hashtable_node<_Value, _CacheHash> _Node;
+    typedef _Node* _Link_type;
     typedef __SSTL_ALLOC(_Node, _Alloc) node_allocator;
 
 private:
@@ -196,37 +394,77 @@ private:
 
     sstl::vector<_Link_type, _Alloc> m_buckets;
 
-    enum { __num_primes = 28 };
+    // buckets being emptied into m_buckets by an incremental rehash,
+    // those before m_migrated have been moved already
+    sstl::vector<_Link_type, _Alloc> m_old_buckets;
+    size_type m_migrated;
+    bool m_incremental;
 
-    static const unsigned long __prime_list[__num_primes] =
-    {
-            53ul,         97ul,         193ul,       389ul,       769ul,
-            1543ul,       3079ul,       6151ul,      12289ul,     24593ul,
-            49157ul,      98317ul,      196613ul,    393241ul,    786433ul,
-            1572869ul,    3145739ul,    6291469ul,   12582917ul,  25165843ul,
-            50331653ul,   100663319ul,  201326611ul, 402653189ul, 805306457ul,
-            1610612741ul, 3221225473ul, 4294967291ul
-    };
+    float m_max_load; // average number of elements per bucket to grow at
 
-    inline unsigned long __next_prime(unsigned long __n)
-    {
-        const unsigned long* first = __prime_list;
-        const unsigned long* last = __prime_list + __num_primes;
-        // FIXME: use sstl::lower_bound
-        const unsigned long* pos = std::lower_bound(first, last, __n);
-        return pos == last ? *(last - 1) : *pos;
-    }
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    unsigned m_threads; // threads rehashing and building in parallel
+#endif
+
+    // number of old buckets moved by each insert while rehashing
+    enum { __rehash_step = 8 };
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    // fewest elements worth starting threads for
+    enum { __parallel_min = 1 << 16 };
+#endif
 
 private:
+    _Link_type m_free_nodes; // destroyed nodes kept for reuse
+    size_type m_free_count;
+
     _Link_type _allocate_node()
     { return node_allocator::allocate(1); }
 
     void _deallocate_node(_Link_type __p)
-    { node_allocator::deallocate(__p, 1); }
+    { node_allocator::deallocate(__p); }
+
+    /**
+     * @brief   Take a node from the free list of the table,
+     *          or request a new one if the free list is empty
+     */
+    _Link_type _get_node()
+    {
+        _Link_type p = m_free_nodes;
+        if(p == nullptr)
+            return _allocate_node();
+        m_free_nodes = p->next;
+        --m_free_count;
+        return p;
+    }
+
+    /**
+     * @brief   Keep a node whose value has been destroyed
+     *          in the free list for later reuse
+     */
+    void _put_node(_Link_type __p)
+    {
+        __p->next = m_free_nodes;
+        m_free_nodes = __p;
+        ++m_free_count;
+    }
+
+    /**
+     * @brief   Return all nodes in the free list to the allocator
+     */
+    void _release_free_nodes()
+    {
+        while(m_free_nodes) {
+            _Link_type next = m_free_nodes->next;
+            _deallocate_node(m_free_nodes);
+            m_free_nodes = next;
+        }
+        m_free_count = 0;
+    }
 
     _Link_type _new_node(const value_type& __val)
     {
-        _Link_type p = _allocate_node();
+        _Link_type p = _get_node();
         p->next = 0;
         __SSTL_TRY {
             construct(&(p->data), __val);
@@ -234,7 +472,8 @@ private:
         }
 #ifdef __SSTL_USE_EXCEPTIONS
         catch(...) {
-            _deallocate_node(p);
+            _put_node(p);
+            throw;
         }
 #endif
         return p;
@@ -242,10 +481,13 @@ private:
 
     void _delete_node(_Link_type __p)
     {
-        sstl::destroy(&(__p->val));
-        _deallocate_node(__p);
+        sstl::destroy(&(__p->data));
+        _put_node(__p);
     }
 
+    size_type _bkt_num(const value_type& __val) const
+    { return _bkt_num_key(m_getKey(__val)); }
+
     size_type _bkt_num(const value_type& __val,
                        const size_type __n) const
     { return _bkt_num_key(m_getKey(__val), __n); }
@@ -255,22 +497,249 @@ private:
 
     size_type _bkt_num_key(const key_type& __k,
                            const size_type __n) const
-    { return hasher(__k) % __n; }
+    { return _BucketPolicy::index(m_hash(__k), __n); }
+
+    size_type _bkt_num_node(_Link_type __p) const
+    { return _bkt_num_node(__p, m_buckets.size()); }
+
+    size_type _bkt_num_node(_Link_type __p, const size_type __n) const
+    { return _BucketPolicy::index(_node_hash(__p, _CacheHash()), __n); }
+
+    size_t _node_hash(_Link_type __p, __true_type) const
+    { return __p->hash; }
+
+    size_t _node_hash(_Link_type __p, __false_type) const
+    { return m_hash(m_getKey(__p->data)); }
+
+    void _set_hash(_Link_type __p, size_t __h, __true_type) const
+    { __p->hash = __h; }
+
+    void _set_hash(_Link_type, size_t, __false_type) const {}
+
+    /**
+     * @brief   Check whether the key of node __p is __k,
+     *          whose hash value is __h
+     */
+    template <class _Kt>
+    bool _equals(_Link_type __p, const _Kt& __k, size_t __h,
+                 __true_type) const
+    { return __p->hash == __h && m_equal(m_getKey(__p->data), __k); }
+
+    template <class _Kt>
+    bool _equals(_Link_type __p, const _Kt& __k, size_t,
+                 __false_type) const
+    { return m_equal(m_getKey(__p->data), __k); }
+
+    bool _rehashing() const { return !m_old_buckets.empty(); }
+
+    /**
+     * @brief   Return the bucket of node __p in m_old_buckets,
+     *          or m_old_buckets.size() if it is in m_buckets
+     */
+    size_type _old_bkt_num_node(_Link_type __p) const
+    {
+        if(!_rehashing())
+            return 0;
+        size_type idx = _bkt_num_node(__p, m_old_buckets.size());
+        return idx >= m_migrated ? idx : m_old_buckets.size();
+    }
+
+    /**
+     * @brief   Return the link to the first node of the chain of __p
+     */
+    _Link_type* _chain_of(_Link_type __p)
+    {
+        size_type idx = _old_bkt_num_node(__p);
+        if(idx < m_old_buckets.size())
+            return &m_old_buckets[idx];
+        return &m_buckets[_bkt_num_node(__p)];
+    }
+
+    /**
+     * @brief   Return the first node of the chains from bucket
+     *          __idx of m_buckets on, then of the old buckets
+     *          not moved yet, or null if there is none
+     */
+    _Link_type _first_node_from(size_type __idx) const
+    {
+        for(; __idx < m_buckets.size(); ++__idx)
+            if(m_buckets[__idx])
+                return m_buckets[__idx];
+        for(__idx = m_migrated; __idx < m_old_buckets.size(); ++__idx)
+            if(m_old_buckets[__idx])
+                return m_old_buckets[__idx];
+        return nullptr;
+    }
+
+    /**
+     * @brief   Return the node after __p in iteration order
+     */
+    _Link_type _next_node(_Link_type __p) const
+    {
+        if(__p->next)
+            return __p->next;
+        size_type idx = _old_bkt_num_node(__p);
+        if(idx < m_old_buckets.size()) {
+            while(++idx < m_old_buckets.size())
+                if(m_old_buckets[idx])
+                    return m_old_buckets[idx];
+            return nullptr;
+        }
+        return _first_node_from(_bkt_num_node(__p) + 1);
+    }
+
+    /**
+     * @brief   Return the link to the first node of the chain
+     *          holding the keys whose hash value is __h
+     */
+    _Link_type* _chain_of_hash(size_t __h)
+    {
+        if(_rehashing()) {
+            size_type idx = _BucketPolicy::index(__h, m_old_buckets.size());
+            if(idx >= m_migrated)
+                return &m_old_buckets[idx];
+        }
+        return &m_buckets[_BucketPolicy::index(__h, m_buckets.size())];
+    }
+
+    /**
+     * @brief   Move up to __n old buckets to m_buckets, and drop
+     *          the old buckets once they are all moved
+     */
+    void _migrate(size_type __n)
+    {
+        const size_type old_n = m_old_buckets.size();
+        for(; __n > 0 && m_migrated < old_n; --__n, ++m_migrated) {
+            _Link_type first = m_old_buckets[m_migrated];
+            while(first) {
+                size_type new_bucket = _bkt_num_node(first);
+                m_old_buckets[m_migrated] = first->next;
+                first->next = m_buckets[new_bucket];
+                m_buckets[new_bucket] = first;
+                first = m_old_buckets[m_migrated];
+            }
+        }
+        if(m_migrated == old_n) {
+            vector<_Link_type, _Alloc> tmp;
+            m_old_buckets.swap(tmp);
+            m_migrated = 0;
+        }
+    }
+
+    void _finish_rehash()
+    {
+        if(_rehashing())
+            _migrate(m_old_buckets.size());
+    }
+
+    /**
+     * @brief   Create node holding __val whose hash value is __h
+     */
+    _Link_type _new_node(const value_type& __val, size_t __h)
+    {
+        _Link_type p = _new_node(__val);
+        _set_hash(p, __h, _CacheHash());
+        return p;
+    }
 
 public:
     hashtable(size_type __n,
               const _HashFunc& __hf,
               const _EqualKey& __eql)
-     : m_hash(__hf), m_equal(__eql), m_getKey(_ExtractKey()), m_num_element(0)
+     : m_hash(__hf), m_equal(__eql), m_getKey(_ExtractKey()), m_num_element(0),
+       m_migrated(0), m_incremental(false), m_max_load(1.0f),
+#ifdef __SSTL_HASHTABLE_PARALLEL
+       m_threads(1),
+#endif
+       m_free_nodes(nullptr), m_free_count(0)
     { _initialize_buckets(__n); }
 
     hashtable(const hashtable& __ht)
      : m_hash(__ht.m_hash), m_equal(__ht.m_equal),
-       m_getKey(__ht.m_getKey), m_buckets(__ht.m_buckets),
-       m_num_element(0)
+       m_getKey(__ht.m_getKey), m_num_element(0),
+       m_migrated(0), m_incremental(__ht.m_incremental),
+       m_max_load(__ht.m_max_load),
+#ifdef __SSTL_HASHTABLE_PARALLEL
+       m_threads(__ht.m_threads),
+#endif
+       m_free_nodes(nullptr), m_free_count(0)
     { _copy_from(__ht); }
 
-    ~hashtable() { clear(); }
+    ~hashtable()
+    {
+        clear();
+        _release_free_nodes();
+    }
+
+    /**
+     * @brief   Replace the contents with a copy of __ht, the old
+     *          nodes are recycled for the copied elements
+     */
+    hashtable& operator=(const hashtable& __ht)
+    {
+        if(this != &__ht) {
+            clear();
+            m_hash = __ht.m_hash;
+            m_equal = __ht.m_equal;
+            m_getKey = __ht.m_getKey;
+            m_incremental = __ht.m_incremental;
+            m_max_load = __ht.m_max_load;
+#ifdef __SSTL_HASHTABLE_PARALLEL
+            m_threads = __ht.m_threads;
+#endif
+            _copy_from(__ht);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+    /**
+     * @brief   Return the function that hashes the keys
+     */
+    hasher hash_func() const { return m_hash; }
+
+    /**
+     * @brief   Return the function that compares keys for equality
+     */
+    key_equal key_eq() const { return m_equal; }
+
+    size_type size() const { return m_num_element; }
+
+    size_type max_size() const { return size_type(-1); }
+
+    bool empty() const { return m_num_element == 0; }
+
+    /**
+     * @brief   Exchange the contents with other hashtable
+     */
+    void swap(hashtable& __ht)
+    {
+        sstl::swap(m_hash, __ht.m_hash);
+        sstl::swap(m_equal, __ht.m_equal);
+        sstl::swap(m_getKey, __ht.m_getKey);
+        sstl::swap(m_num_element, __ht.m_num_element);
+        m_buckets.swap(__ht.m_buckets);
+        m_old_buckets.swap(__ht.m_old_buckets);
+        sstl::swap(m_migrated, __ht.m_migrated);
+        sstl::swap(m_incremental, __ht.m_incremental);
+        sstl::swap(m_max_load, __ht.m_max_load);
+#ifdef __SSTL_HASHTABLE_PARALLEL
+        sstl::swap(m_threads, __ht.m_threads);
+#endif
+        sstl::swap(m_free_nodes, __ht.m_free_nodes);
+        sstl::swap(m_free_count, __ht.m_free_count);
+    }
+
+    iterator begin() { return iterator(_first_node_from(0), this); }
+
+    const_iterator begin() const
+    { return const_iterator(_first_node_from(0), this); }
+
+    iterator end() { return iterator(nullptr, this); }
+
+    const_iterator end() const { return const_iterator(nullptr, this); }
 
     /**
      * @brief   Insert element if the container doesn't contain
@@ -291,21 +760,153 @@ public:
     pair<iterator, bool>
     insert_unique_noresize(const value_type& __val)
     {
-        const size_type& idx = _bkt_num(__val);
-        _Link_type first = m_buckets[idx];
-        for(_Link_type cur = first; cur; cur->next)
+        const size_t h = m_hash(m_getKey(__val));
+        _Link_type* chain = _chain_of_hash(h);
+        for(_Link_type cur = *chain; cur; cur = cur->next)
             // the node already exists in bucket
-            if(m_equal(m_getKey(cur->data), m_getKey(__val)))
+            if(_equals(cur, m_getKey(__val), h, _CacheHash()))
                 return pair<iterator, bool>(iterator(cur, this), false);
 
         // create new node and connect it with bucket
-        _Link_type tmp = _new_node(__val);
-        tmp->next = first;
-        m_buckets[idx] = tmp;
+        _Link_type tmp = _new_node(__val, h);
+        tmp->next = *chain;
+        *chain = tmp;
         ++m_num_element;
         return pair<iterator, bool>(iterator(tmp, this), true);
     }
 
+    /**
+     * @brief   Insert the elements in the range [__first, __last)
+     *          whose keys are not in the container yet
+     */
+    template <class _InputIter>
+    void insert_unique(_InputIter __first, _InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert_unique(*__first);
+    }
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Insert the elements in the range [__first, __last)
+     *          whose keys are not in the container yet, on the number
+     *          of threads set by parallel_threads. The buckets grow
+     *          once for the whole range, then the elements are
+     *          partitioned by bucket so that each thread links the
+     *          elements of its own range of buckets. A node is taken
+     *          for every element beforehand, the nodes of duplicates
+     *          go to the free list. Copying _Value must be safe from
+     *          several threads, see parallel_threads
+     */
+    template <class _RandomIter>
+    void insert_unique_parallel(_RandomIter __first, _RandomIter __last)
+    {
+        const size_type n = __last - __first;
+        const unsigned nt = m_threads;
+        if(nt < 2 || n < size_type(__parallel_min)) {
+            insert_unique(__first, __last);
+            return;
+        }
+        _finish_rehash();
+        reserve(m_num_element + n);
+
+        const size_type nb = m_buckets.size();
+        const size_type chunk = (nb + nt - 1) / nt;
+        vector<size_t, _Alloc> hashes(n, 0);
+        vector<size_type, _Alloc> pos(nt * nt, 0); // pos[t * nt + p]
+        vector<size_type, _Alloc> bounds(nt + 1, n);
+        vector<size_type, _Alloc> order(n, 0);
+        vector<size_type, _Alloc> added(nt, 0);
+        vector<_Link_type, _Alloc> nodes(n, (_Link_type)0);
+        std::exception_ptr errors[__max_threads];
+        __SSTL_TRY {
+            for(size_type i = 0; i < n; ++i)
+                nodes[i] = _get_node();
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            for(size_type i = 0; i < n && nodes[i]; ++i)
+                _put_node(nodes[i]);
+            throw;
+        }
+#endif
+
+        // thread t hashes its slice of the range
+        // and counts the elements for each thread p
+        auto count = [&](unsigned t) {
+            __SSTL_TRY {
+                for(size_type i = n * t / nt; i < n * (t + 1) / nt; ++i) {
+                    hashes[i] = m_hash(m_getKey(__first[i]));
+                    ++pos[t * nt + _BucketPolicy::index(hashes[i], nb) / chunk];
+                }
+            }
+#ifdef __SSTL_USE_EXCEPTIONS
+            catch(...) { errors[t] = std::current_exception(); }
+#endif
+        };
+        // thread t lays out its slice grouped by thread p
+        auto scatter = [&](unsigned t) {
+            for(size_type i = n * t / nt; i < n * (t + 1) / nt; ++i)
+                order[pos[t * nt + _BucketPolicy::index(hashes[i], nb) / chunk]++] = i;
+        };
+        // thread p links the elements of its buckets, which are
+        // still in the order of the range, so the first one wins
+        auto link = [&](unsigned p) {
+            __SSTL_TRY {
+                for(size_type j = bounds[p]; j < bounds[p + 1]; ++j) {
+                    const size_type i = order[j];
+                    const size_t h = hashes[i];
+                    _Link_type* chain = &m_buckets[_BucketPolicy::index(h, nb)];
+                    _Link_type cur = *chain;
+                    while(cur && !_equals(cur, m_getKey(__first[i]), h, _CacheHash()))
+                        cur = cur->next;
+                    if(cur)
+                        continue;
+                    construct(&(nodes[i]->data), __first[i]);
+                    _set_hash(nodes[i], h, _CacheHash());
+                    nodes[i]->next = *chain;
+                    *chain = nodes[i];
+                    nodes[i] = 0;
+                    ++added[p];
+                }
+            }
+#ifdef __SSTL_USE_EXCEPTIONS
+            catch(...) { errors[p] = std::current_exception(); }
+#endif
+        };
+
+        __parallel_run(nt, count);
+        bool failed = false;
+        for(unsigned t = 0; t < nt; ++t)
+            failed = failed || errors[t];
+        if(!failed) {
+            // pos[t * nt + p] becomes where the elements of slice t
+            // for thread p start, grouped by p, then by t
+            size_type start = 0;
+            for(unsigned p = 0; p < nt; ++p) {
+                bounds[p] = start;
+                for(unsigned t = 0; t < nt; ++t) {
+                    const size_type c = pos[t * nt + p];
+                    pos[t * nt + p] = start;
+                    start += c;
+                }
+            }
+            __parallel_run(nt, scatter);
+            __parallel_run(nt, link);
+        }
+
+        for(unsigned p = 0; p < nt; ++p)
+            m_num_element += added[p];
+        for(size_type i = 0; i < n; ++i)
+            if(nodes[i])
+                _put_node(nodes[i]);
+        for(unsigned t = 0; t < nt; ++t)
+            if(errors[t])
+                std::rethrow_exception(errors[t]);
+    }
+
+#endif
+
     /**
      * @brief   Insert element no matter whether the container
      *          contains an element with an equivalent key
@@ -324,28 +925,203 @@ public:
      */
     iterator insert_equal_noresize(const value_type& __val)
     {
-        const size_type idx = _bkt_num(__val);
-        _Link_type first = m_buckets[idx];
+        const size_t h = m_hash(m_getKey(__val));
+        _Link_type* chain = _chain_of_hash(h);
 
-        for(_Link_type cur = first; cur; cur = cur->next)
+        for(_Link_type cur = *chain; cur; cur = cur->next)
             // the node already exists in bucket
-            if(m_euqal(m_getKey(cur->data), m_getKey(__val))) {
-                _Link_type tmp = _new_node(__val);
+            if(_equals(cur, m_getKey(__val), h, _CacheHash())) {
+                _Link_type tmp = _new_node(__val, h);
                 tmp->next = cur->next;
                 cur->next = tmp;
                 ++m_num_element;
                 return iterator(tmp, this);
             }
         // the node doesn't exist in bucket
-        _Link_type tmp = _new_node(__val);
-        tmp->next = first;
-        m_buckets[idx] = tmp;
+        _Link_type tmp = _new_node(__val, h);
+        tmp->next = *chain;
+        *chain = tmp;
         ++m_num_element;
         return iterator(tmp, this);
     }
 
+    template <class _InputIter>
+    void insert_equal(_InputIter __first, _InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert_equal(*__first);
+    }
+
+    /**
+     * @brief   Remove all elements with key equivalent to __k
+     * @return  The number of elements removed
+     */
+    size_type erase(const key_type& __k)
+    {
+        const size_t h = m_hash(__k);
+        size_type erased = 0;
+        _Link_type* link = _chain_of_hash(h);
+        while(*link) {
+            _Link_type cur = *link;
+            if(_equals(cur, __k, h, _CacheHash())) {
+                *link = cur->next;
+                _delete_node(cur);
+                ++erased;
+            } else
+                link = &cur->next;
+        }
+        m_num_element -= erased;
+        return erased;
+    }
+
+    /**
+     * @brief   Remove the element at __it
+     */
+    void erase(const const_iterator& __it)
+    {
+        _Link_type p = __it.m_cur;
+        if(p == nullptr)
+            return;
+        _Link_type* link = _chain_of(p);
+        while(*link != p)
+            link = &(*link)->next;
+        *link = p->next;
+        _delete_node(p);
+        --m_num_element;
+    }
+
+    /**
+     * @brief   Remove the elements in the range [__first, __last)
+     */
+    void erase(const_iterator __first, const_iterator __last)
+    {
+        while(__first != __last) {
+            const_iterator next = __first;
+            ++next;
+            erase(__first);
+            __first = next;
+        }
+    }
+
+    /**
+     * @brief   Grow the buckets to hold __hint_n elements
+     */
+    void resize(size_type __hint_n) { _resize(__hint_n); }
+
+    /**
+     * @brief   Return the average number of elements per bucket
+     */
+    float load_factor() const
+    { return float(m_num_element) / float(m_buckets.size()); }
+
+    /**
+     * @brief   Return the load factor past which inserting
+     *          grows the buckets, 1.0 by default
+     */
+    float max_load_factor() const { return m_max_load; }
+
+    /**
+     * @brief   Set the load factor past which inserting grows the
+     *          buckets, growing them now if the table is past it.
+     *          Use shrink_to_fit to give back buckets after raising it
+     * @param   __z: the new max load factor, which must be positive,
+     *          otherwise invalid_argument is thrown
+     */
+    void max_load_factor(float __z)
+    {
+        if(!(__z > 0.0f)) { // NaN too
+#ifdef __SSTL_USE_EXCEPTIONS
+            throw std::invalid_argument("hashtable: max load factor must be positive");
+#else
+            return;
+#endif
+        }
+        m_max_load = __z;
+        reserve(m_num_element);
+    }
+
+    /**
+     * @brief   Grow the buckets at once so that __n elements can be
+     *          inserted without rehashing, see max_load_factor
+     */
+    void reserve(size_type __n)
+    {
+        if(_buckets_for(__n) > m_buckets.size())
+            rehash(_buckets_for(__n));
+    }
+
+    /**
+     * @brief   Move the elements at once to the smallest number of
+     *          buckets not less than __n that keeps the load factor
+     *          at most max_load_factor. This shrinks the buckets too
+     */
+    void rehash(size_type __n)
+    {
+        _finish_rehash();
+        const size_type new_n =
+            _BucketPolicy::next_size(sstl::max(__n, _buckets_for(m_num_element)));
+        if(new_n != m_buckets.size())
+            _rehash_buckets(new_n);
+    }
+
     /**
-     * @brief   Clean all elements from container
+     * @brief   Shrink the buckets to the fewest that hold the
+     *          elements, like after erasing most of them
+     */
+    void shrink_to_fit() { rehash(0); }
+
+    /**
+     * @brief   Turn incremental rehashing on or off. When it is on,
+     *          growing the buckets only allocates the new buckets,
+     *          and each later insert moves a few of the old buckets
+     *          to them, so no single insert pays for moving all
+     *          elements. Lookups search the old buckets not moved
+     *          yet as well. Inserting still invalidates iterators
+     */
+    void incremental_rehash(bool __on)
+    {
+        if(!__on)
+            _finish_rehash();
+        m_incremental = __on;
+    }
+
+    bool incremental_rehash() const { return m_incremental; }
+
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Set the number of threads, 1 by default and at most
+     *          __max_threads, that rehash the buckets when they grow
+     *          eagerly or on rehash(), and that insert_unique_parallel
+     *          uses. Tables of fewer than __parallel_min elements are
+     *          rehashed on the calling thread. The threads call the
+     *          hash and key_equal functions at once and take no nodes
+     *          from the allocator, which needn't be thread safe
+     */
+    void parallel_threads(unsigned __n)
+    { m_threads = sstl::max(1u, sstl::min(__n, unsigned(__max_threads))); }
+
+    unsigned parallel_threads() const { return m_threads; }
+#endif
+
+    /**
+     * @brief   Make sure that __n elements can be held without
+     *          requesting nodes from the allocator
+     * @param   __n: number of elements to hold
+     */
+    void reserve_nodes(size_type __n)
+    {
+        for(size_type held = m_num_element + m_free_count; held < __n; ++held)
+            _put_node(_allocate_node());
+    }
+
+    /**
+     * @brief   Return the nodes kept for reuse to the allocator
+     */
+    void release_nodes() { _release_free_nodes(); }
+
+    /**
+     * @brief   Clean all elements from container, keeping
+     *          their nodes for reuse
      */
     void clear()
     {
@@ -358,21 +1134,118 @@ public:
             }
             m_buckets[idx] = nullptr;
         }
+        for(size_type idx = m_migrated; idx < m_old_buckets.size(); ++idx) {
+            _Link_type cur = m_old_buckets[idx];
+            while(cur) {
+                _Link_type next = cur->next;
+                _delete_node(cur);
+                cur = next;
+            }
+        }
+        vector<_Link_type, _Alloc> tmp;
+        m_old_buckets.swap(tmp);
+        m_migrated = 0;
         m_num_element = 0;
     }
 
+private:
     /**
-     * @brief   Find an element with key equivalent to key
-     * @param   __k: key value of the element to search for
+     * @brief   Return the first node with key equivalent to __k,
+     *          which may be a key_type or, with transparent hash
+     *          and key_equal functions, anything they accept
      */
-    iterator find(const key_type& __k) {
-        size_type idx = _bkt_num_key(__k);
+    template <class _Kt>
+    _Link_type _find_node(const _Kt& __k) const
+    {
+        const size_t h = m_hash(__k);
         _Link_type first;
         // try to find the node from bucket
-        for(first = m_buckets[idx];
-            first && !equal(m_getKey(first->data), __k);
+        for(first = *const_cast<hashtable*>(this)->_chain_of_hash(h);
+            first && !_equals(first, __k, h, _CacheHash());
             first = first->next) {}
-        return iterator(first, this);
+        return first;
+    }
+
+    template <class _Kt>
+    pair<iterator, iterator> _equal_range(const _Kt& __k) const
+    {
+        hashtable* self = const_cast<hashtable*>(this);
+        _Link_type first = _find_node(__k);
+        if(!first)
+            return pair<iterator, iterator>(iterator(nullptr, self),
+                                            iterator(nullptr, self));
+        _Link_type cur = first;
+        while(cur->next && m_equal(m_getKey(cur->next->data), __k))
+            cur = cur->next;
+        iterator last(cur, self);
+        return pair<iterator, iterator>(iterator(first, self), ++last);
+    }
+
+    template <class _Kt>
+    size_type _count(const _Kt& __k) const
+    {
+        const size_t h = m_hash(__k);
+        size_type count = 0;
+        for(_Link_type cur = *const_cast<hashtable*>(this)->_chain_of_hash(h);
+            cur; cur = cur->next)
+            if(_equals(cur, __k, h, _CacheHash()))
+                ++count;
+        return count;
+    }
+
+public:
+    /**
+     * @brief   Find an element with key equivalent to key
+     * @param   __k: key value of the element to search for
+     */
+    iterator find(const key_type& __k)
+    { return iterator(_find_node(__k), this); }
+
+    const_iterator find(const key_type& __k) const
+    { return const_iterator(_find_node(__k), this); }
+
+    /**
+     * @brief   Find an element with key equivalent to __k without
+     *          building a key_type, when both the hash and the
+     *          key_equal functions declare is_transparent
+     */
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, iterator, _Kt>::type
+    find(const _Kt& __k)
+    { return iterator(_find_node(__k), this); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, const_iterator, _Kt>::type
+    find(const _Kt& __k) const
+    { return const_iterator(_find_node(__k), this); }
+
+    /**
+     * @brief   Return the range of elements with key equivalent
+     *          to __k, which are adjacent in their bucket
+     */
+    pair<iterator, iterator> equal_range(const key_type& __k)
+    { return _equal_range(__k); }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    {
+        pair<iterator, iterator> p = _equal_range(__k);
+        return pair<const_iterator, const_iterator>(p.first, p.second);
+    }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey,
+                                pair<iterator, iterator>, _Kt>::type
+    equal_range(const _Kt& __k)
+    { return _equal_range(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey,
+            pair<const_iterator, const_iterator>, _Kt>::type
+    equal_range(const _Kt& __k) const
+    {
+        pair<iterator, iterator> p = _equal_range(__k);
+        return pair<const_iterator, const_iterator>(p.first, p.second);
     }
 
     /**
@@ -381,15 +1254,108 @@ public:
      * @param   key value of the elements to count
      */
     size_type count(const key_type& __k) const
+    { return _count(__k); }
+
+    template <class _Kt>
+    typename __hash_transparent<_HashFunc, _EqualKey, size_type, _Kt>::type
+    count(const _Kt& __k) const
+    { return _count(__k); }
+
+private:
+    /**
+     * @brief   Look up __keys[0, __n) and store the first node with
+     *          each key in __found[i], or the number of nodes with
+     *          it in __counts[i] when __counts is not null.
+     *          Every key goes through three stages __distance keys
+     *          apart: hash it and prefetch its bucket, read the bucket
+     *          and prefetch the first node, then walk the chain. So the
+     *          cache misses of several keys are pending at once instead
+     *          of one after the other. The oldest key is resolved first
+     *          in each round, before its slot is reused
+     */
+    void _probe_batch(const key_type* __keys, size_type __n,
+                      _Link_type* __found, size_type* __counts) const
     {
-        const size_type idx = _bkt_num_key(__k);
-        size_type count = 0;
-        for(_Link_type cur = m_buckets[idx]; cur; cur = cur->next)
-            if(m_equal(m_getKey(cur->data), __k))
-                ++count;
-        return count;
+        enum { __distance = 8, __window = 2 * __distance };
+        hashtable* self = const_cast<hashtable*>(this);
+        size_t hashes[__window];
+        _Link_type* links[__window];
+        _Link_type heads[__window];
+
+        for(size_type i = 0; i < __n + 2 * __distance; ++i) {
+            if(i >= 2 * __distance) {
+                const size_type j = i - 2 * __distance;
+                const size_type s = j % __window;
+                _Link_type cur = heads[s];
+                if(__counts) {
+                    size_type count = 0;
+                    for(; cur; cur = cur->next)
+                        if(_equals(cur, __keys[j], hashes[s], _CacheHash()))
+                            ++count;
+                    __counts[j] = count;
+                } else {
+                    while(cur && !_equals(cur, __keys[j], hashes[s],
+                                          _CacheHash()))
+                        cur = cur->next;
+                    __found[j] = cur;
+                }
+            }
+            if(i >= __distance && i - __distance < __n) {
+                const size_type s = (i - __distance) % __window;
+                heads[s] = *links[s];
+                if(heads[s])
+                    __SSTL_PREFETCH(heads[s]);
+            }
+            if(i < __n) {
+                const size_type s = i % __window;
+                hashes[s] = m_hash(__keys[i]);
+                links[s] = self->_chain_of_hash(hashes[s]);
+                __SSTL_PREFETCH(links[s]);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief   Find the keys __keys[0, __n), like __n calls to find
+     *          but faster on tables much larger than the cache, since
+     *          the lookups overlap their memory accesses
+     * @param   __out: receives find(__keys[i]) in __out[i]
+     */
+    void find_batch(const key_type* __keys, size_type __n,
+                    iterator* __out)
+    {
+        enum { __chunk = 64 };
+        _Link_type nodes[__chunk];
+        for(size_type i = 0; i < __n; i += __chunk) {
+            const size_type len = sstl::min(size_type(__chunk), __n - i);
+            _probe_batch(__keys + i, len, nodes, nullptr);
+            for(size_type j = 0; j < len; ++j)
+                __out[i + j] = iterator(nodes[j], this);
+        }
+    }
+
+    void find_batch(const key_type* __keys, size_type __n,
+                    const_iterator* __out) const
+    {
+        enum { __chunk = 64 };
+        _Link_type nodes[__chunk];
+        for(size_type i = 0; i < __n; i += __chunk) {
+            const size_type len = sstl::min(size_type(__chunk), __n - i);
+            _probe_batch(__keys + i, len, nodes, nullptr);
+            for(size_type j = 0; j < len; ++j)
+                __out[i + j] = const_iterator(nodes[j], this);
+        }
     }
 
+    /**
+     * @brief   Count the keys __keys[0, __n), see find_batch
+     * @param   __out: receives count(__keys[i]) in __out[i]
+     */
+    void count_batch(const key_type* __keys, size_type __n,
+                     size_type* __out) const
+    { _probe_batch(__keys, __n, nullptr, __out); }
+
     /**
      * @brief   Return the number of buckets
      */
@@ -400,19 +1366,71 @@ public:
      * @brief   Return the maximum number of buckets
      */
     size_type max_bucket_count() const
-    { return __prime_list[__num_primes - 1]; }
+    { return _BucketPolicy::max_size(); }
 
     /**
-     * @brief   Return the number of elements in specific bucket
+     * @brief   Return the number of elements in specific bucket.
+     *          While an incremental rehash is going on, this counts
+     *          the elements of the old buckets not moved yet which
+     *          belong to the bucket, which takes time linear in size
      */
     size_type elems_in_bucket(size_type __idx) const
     {
         size_type count = 0;
         for(_Link_type cur = m_buckets[__idx]; cur; cur = cur->next)
             ++count;
+        for(size_type i = m_migrated; i < m_old_buckets.size(); ++i)
+            for(_Link_type cur = m_old_buckets[i]; cur; cur = cur->next)
+                if(_bkt_num_node(cur) == __idx)
+                    ++count;
         return count;
     }
 
+    /**
+     * @brief   Check whether two hashtables hold the same elements,
+     *          regardless of their order
+     */
+    friend bool operator==(const hashtable& __x, const hashtable& __y)
+    {
+        if(__x.size() != __y.size())
+            return false;
+        for(const_iterator it = __x.begin(); it != __x.end(); ) {
+            pair<const_iterator, const_iterator> rx =
+                    __x.equal_range(__x.m_getKey(*it));
+            pair<const_iterator, const_iterator> ry =
+                    __y.equal_range(__x.m_getKey(*it));
+            // the groups must be permutations of each other: each
+            // value, counted at its first occurrence in the group of
+            // __x, occurs as often in both groups
+            difference_type n = 0;
+            for(const_iterator i = rx.first; i != rx.second; ++i, ++n) {
+                const_iterator k = rx.first;
+                while(!(*k == *i))
+                    ++k;
+                if(k != i)
+                    continue;
+                difference_type c = 0;
+                for(k = i; k != rx.second; ++k)
+                    if(*k == *i)
+                        ++c;
+                for(const_iterator j = ry.first; j != ry.second; ++j)
+                    if(*j == *i)
+                        --c;
+                if(c != 0)
+                    return false;
+            }
+            for(const_iterator j = ry.first; j != ry.second; ++j)
+                --n;
+            if(n != 0)
+                return false;
+            it = rx.second;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const hashtable& __x, const hashtable& __y)
+    { return !(__x == __y); }
+
 private:
     /**
      * @brief   Initialize buckets in the container
@@ -420,7 +1438,7 @@ private:
      */
     void _initialize_buckets(size_type __n)
     {
-        const size_type new_n = __next_prime(__n);
+        const size_type new_n = _BucketPolicy::next_size(__n);
         m_buckets.reserve(new_n);
         m_buckets.insert(m_buckets.end(), new_n, (_Link_type)0);
         m_num_element = 0;
@@ -432,21 +1450,41 @@ private:
      */
     void _copy_from(const hashtable& __ht)
     {
-        m_buckets.clear();
-        m_buckets.reserve(__ht.m_buckets.size());
-        m_buckets.insert(m_buckets.end(), __ht.m_buckets.size(), (_Link_type)0);
+        if(m_buckets.size() == __ht.m_buckets.size()) {
+            sstl::fill(m_buckets.begin(), m_buckets.end(), (_Link_type)0);
+        } else {
+            m_buckets.clear();
+            m_buckets.reserve(__ht.m_buckets.size());
+            m_buckets.insert(m_buckets.end(), __ht.m_buckets.size(), (_Link_type)0);
+        }
 
         __SSTL_TRY {
+            if(__ht._rehashing()) {
+                // hang each node in its bucket of the new size
+                for(_Link_type cur = __ht._first_node_from(0); cur;
+                    cur = __ht._next_node(cur)) {
+                    _Link_type copy = _new_node(cur->data,
+                            _node_hash(cur, _CacheHash()));
+                    _Link_type& first = m_buckets[_bkt_num_node(copy)];
+                    copy->next = first;
+                    first = copy;
+                }
+                m_num_element = __ht.m_num_element;
+                return;
+            }
+
             _Link_type cur = NULL;
             // copy all nodes from all bucket
             for(size_type idx = 0; idx < __ht.m_buckets.size(); ++idx) {
                 cur = __ht.m_buckets[idx];
                 if(cur) {
                     // copy all nodes from certain bucket
-                    _Link_type copy = _new_node(cur->data);
+                    _Link_type copy = _new_node(cur->data,
+                            _node_hash(cur, _CacheHash()));
                     m_buckets[idx] = copy;
                     for(_Link_type next = cur->next; next; cur = next, next = cur->next) {
-                        copy->next = _new_node(next->data);
+                        copy->next = _new_node(next->data,
+                                _node_hash(next, _CacheHash()));
                         copy = copy->next;
                     }
                 }
@@ -461,47 +1499,173 @@ private:
     #endif
     }
 
+#ifdef __SSTL_HASHTABLE_PARALLEL
+    /**
+     * @brief   Move all elements to __new_n new buckets on m_threads
+     *          threads. Each thread first empties its share of the
+     *          old buckets into one list per thread, by the range of
+     *          new buckets each thread owns, then links the nodes of
+     *          the lists for its own range, so no bucket is written
+     *          by two threads
+     */
+    void _rehash_parallel(size_type __new_n)
+    {
+        const unsigned nt = m_threads;
+        const size_type old_n = m_buckets.size();
+        const size_type chunk = (__new_n + nt - 1) / nt;
+        vector<_Link_type, _Alloc> tmp(__new_n, (_Link_type)0);
+        vector<_Link_type, _Alloc> parts(nt * nt, (_Link_type)0);
+        std::exception_ptr errors[__max_threads];
+
+        // thread t empties old buckets into parts[t * nt + p]
+        auto split = [&](unsigned t) {
+            __SSTL_TRY {
+                for(size_type idx = old_n * t / nt; idx < old_n * (t + 1) / nt; ++idx) {
+                    _Link_type first = m_buckets[idx];
+                    while(first) {
+                        _Link_type* part = &parts[t * nt + _bkt_num_node(first, __new_n) / chunk];
+                        m_buckets[idx] = first->next;
+                        first->next = *part;
+                        *part = first;
+                        first = m_buckets[idx];
+                    }
+                }
+            }
+#ifdef __SSTL_USE_EXCEPTIONS
+            catch(...) { errors[t] = std::current_exception(); }
+#endif
+        };
+        // thread p links parts[t * nt + p] into its new buckets
+        auto link = [&](unsigned p) {
+            __SSTL_TRY {
+                for(unsigned t = 0; t < nt; ++t) {
+                    _Link_type* part = &parts[t * nt + p];
+                    while(*part) {
+                        _Link_type first = *part;
+                        size_type new_bucket = _bkt_num_node(first, __new_n);
+                        *part = first->next;
+                        first->next = tmp[new_bucket];
+                        tmp[new_bucket] = first;
+                    }
+                }
+            }
+#ifdef __SSTL_USE_EXCEPTIONS
+            catch(...) { errors[p] = std::current_exception(); }
+#endif
+        };
+
+        __parallel_run(nt, split);
+        bool failed = false;
+        for(unsigned t = 0; t < nt; ++t)
+            failed = failed || errors[t];
+        if(!failed)
+            __parallel_run(nt, link);
+        for(unsigned t = 0; t < nt; ++t)
+            failed = failed || errors[t];
+        if(!failed) {
+            m_buckets.swap(tmp);
+            return;
+        }
+
+        // like _rehash_buckets, delete the nodes moved out of the
+        // old buckets, the ones still there stay in the table
+        for(size_type idx = 0; idx < tmp.size(); ++idx)
+            parts.push_back(tmp[idx]);
+        for(size_type idx = 0; idx < parts.size(); ++idx) {
+            while(parts[idx]) {
+                _Link_type next = parts[idx]->next;
+                _delete_node(parts[idx]);
+                --m_num_element;
+                parts[idx] = next;
+            }
+        }
+        for(unsigned t = 0; t < nt; ++t)
+            if(errors[t])
+                std::rethrow_exception(errors[t]);
+    }
+
+#endif
+
+    /**
+     * @brief   Return the number of buckets holding __n elements
+     *          at the max load factor
+     */
+    size_type _buckets_for(size_type __n) const
+    {
+        const double b = double(__n) / m_max_load;
+        const size_type n = size_type(b);
+        return double(n) < b ? n + 1 : n;
+    }
+
     /**
      * @brief   Resize the container to certain size
      * @param   __hint_n: new size of container
      */
     void _resize(size_type __hint_n)
     {
+        if(_rehashing())
+            _migrate(__rehash_step);
         const size_type old_n = m_buckets.size();
-        if(__hint_n > old_n) {
-            // find the next larger prime number
-            const size_type new_n = __next_prime(__hint_n);
-            if(new_n > old_n){
-                // create an new vector and move all elements to new vector
+        const size_type need = _buckets_for(__hint_n);
+        if(need > old_n) {
+            // find the next larger bucket count
+            const size_type new_n = _BucketPolicy::next_size(need);
+            if(new_n > old_n && m_incremental) {
+                // the buckets double at least, so the last rehash
+                // is done unless it was started by resize()
+                _finish_rehash();
                 vector<_Link_type, _Alloc> tmp(new_n, (_Link_type)0);
-                __SSTL_TRY {
-                    for(size_type idx = 0; idx < old_n; ++idx) {
-                        _Link_type first = m_buckets[idx];
-                        while(first) { // rehash all nodes in bucket
-                            size_type new_bucket = _bkt_num(first->val, new_n);
-                            m_buckets[idx] = first->next; // disconnect first from old bucket
-                            first->next = tmp[new_bucket];
-                            tmp[new_bucket] = first; // connect node with new bucket
-                            first = m_buckets[idx];
-                        }
-                    }
-                    m_buckets.swap(tmp);
+                m_old_buckets.swap(m_buckets);
+                m_buckets.swap(tmp);
+                m_migrated = 0;
+                _migrate(__rehash_step);
+            } else if(new_n > old_n) {
+                _rehash_buckets(new_n);
+            }
+        }
+    }
+
+    /**
+     * @brief   Move all elements to __new_n new buckets at once
+     */
+    void _rehash_buckets(size_type __new_n)
+    {
+#ifdef __SSTL_HASHTABLE_PARALLEL
+        if(m_threads > 1 && m_num_element >= size_type(__parallel_min)) {
+            _rehash_parallel(__new_n);
+            return;
+        }
+#endif
+        const size_type old_n = m_buckets.size();
+        // create an new vector and move all elements to new vector
+        vector<_Link_type, _Alloc> tmp(__new_n, (_Link_type)0);
+        __SSTL_TRY {
+            for(size_type idx = 0; idx < old_n; ++idx) {
+                _Link_type first = m_buckets[idx];
+                while(first) { // rehash all nodes in bucket
+                    size_type new_bucket = _bkt_num_node(first, __new_n);
+                    m_buckets[idx] = first->next; // disconnect first from old bucket
+                    first->next = tmp[new_bucket];
+                    tmp[new_bucket] = first; // connect node with new bucket
+                    first = m_buckets[idx];
                 }
+            }
+            m_buckets.swap(tmp);
+        }
 #ifdef __SSTL_USE_EXCEPTIONS
-                catch(...) {
-                    // delete all nodes in new vector
-                    for(size_type idx = 0; idx < tmp.size(); ++idx) {
-                        while(tmp[idx]) {
-                            _Link_type next = tmp[idx]->next;
-                            _delete_node(tmp[idx]);
-                            tmp[idx] = next;
-                        }
-                    }
-                    throw;
+        catch(...) {
+            // delete all nodes in new vector
+            for(size_type idx = 0; idx < tmp.size(); ++idx) {
+                while(tmp[idx]) {
+                    _Link_type next = tmp[idx]->next;
+                    _delete_node(tmp[idx]);
+                    --m_num_element;
+                    tmp[idx] = next;
                 }
-#endif
             }
+            throw;
         }
+#endif
     }
 };
 
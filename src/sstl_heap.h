@@ -1,28 +1,52 @@
 #ifndef SSTL_HEAP_H
 #define SSTL_HEAP_H
 
+#include <cstddef>
 #include "sstl_traits.h"
+#include "sstl_iterator.h"
 
 
 namespace sstl {
 
+/**
+ * The heap algorithms take the arity of the heap as an optional
+ * first template argument, 2 by default, e.g. push_heap<4>(first, last).
+ * Node i has children _Arity * i + 1 to _Arity * i + _Arity. A wider
+ * heap has fewer levels, which makes pushing cheaper, but popping
+ * compares all children of each node on the way down and gets slower.
+ * The arity must be at least 2, and the heap must be used with the
+ * same arity throughout.
+ */
+
+/**
+ * @brief   Compare with operator<, for the overloads
+ *          taking no function object
+ */
+struct __heap_less {
+    template <class T>
+    bool operator()(const T& __x, const T& __y) const { return __x < __y; }
+};
+
 /**
  * @param   __first: iterator to the first element
  * @param   __holeIndex: length of the range of elements
  * @param   __topIndex: distance of 0
  * @param   __val: value to insert
+ * @param   __comp: function object for "less than"
  */
-template <class RandomAccessIter, class Distance, class T>
+template <size_t _Arity, class RandomAccessIter, class Distance,
+          class T, class Compare>
 inline void
-__push_heap(RandomAccessIter __first, 
+__push_heap(RandomAccessIter __first,
             Distance __holeIndex,
-            Distance topIndex, T __val)
+            Distance topIndex, T __val, Compare __comp)
 {
-    Distance parent = (__holeIndex - 1) / 2; // index of parent node
-    while(__holeIndex > topIndex && *(__first + parent) < __val) {
+    static_assert(_Arity >= 2, "a heap needs at least 2 children per node");
+    Distance parent = (__holeIndex - 1) / Distance(_Arity); // index of parent node
+    while(__holeIndex > topIndex && __comp(*(__first + parent), __val)) {
         *(__first + __holeIndex) = *(__first + parent);
         __holeIndex = parent;
-        parent = (__holeIndex - 1) / 2;
+        parent = (__holeIndex - 1) / Distance(_Arity);
     }
     *(__first + __holeIndex) = __val;
 }
@@ -31,14 +55,15 @@ __push_heap(RandomAccessIter __first,
  * @brief   Get the type of distance and the type of
  *          iterator value
  */
-template<class RandomAccessIter, class Distance, class T>
+template <size_t _Arity, class RandomAccessIter, class Compare,
+          class Distance, class T>
 inline void
-__push_heap_aux(RandomAccessIter __first, 
+__push_heap_aux(RandomAccessIter __first,
                 RandomAccessIter __last,
-                Distance*, T*)
+                Compare __comp, Distance*, T*)
 {
-    __push_heap(__first, DISTANCE(__last - __first - 1),
-                Distance(0), T(*(__last - 1)));
+    __push_heap<_Arity>(__first, Distance(__last - __first - 1),
+                        Distance(0), T(*(__last - 1)), __comp);
 }
 
 /**
@@ -46,57 +71,84 @@ __push_heap_aux(RandomAccessIter __first,
  * @param   __first, __last: the range of elements
  *          defining the heap to modify
  */
-template <class RandomAccessIter>
+template <size_t _Arity = 2, class RandomAccessIter>
 inline void
 push_heap(RandomAccessIter __first,
           RandomAccessIter __last)
 {
-    __push_heap_aux(__first, __last, __DISTANCE_TYPE(__first),
-                    ____val_TYPE(__first));
+    __push_heap_aux<_Arity>(__first, __last, __heap_less(),
+                            __DISTANCE_TYPE(__first), __VALUE_TYPE(__first));
 }
 
-template <class RandomAccessIter, class Distance, class T>
+/**
+ * @param   __comp: function object for "less than", the heap
+ *          keeps the greatest element first
+ */
+template <size_t _Arity = 2, class RandomAccessIter, class Compare>
 inline void
-__adjust_heap(RandomAccessIter __first, 
+push_heap(RandomAccessIter __first,
+          RandomAccessIter __last, Compare __comp)
+{
+    __push_heap_aux<_Arity>(__first, __last, __comp,
+                            __DISTANCE_TYPE(__first), __VALUE_TYPE(__first));
+}
+
+/**
+ * @brief   Fill the hole at __holeIndex with its greatest child down
+ *          to a leaf, then put __val there and push it up
+ */
+template <size_t _Arity, class RandomAccessIter, class Distance,
+          class T, class Compare>
+inline void
+__adjust_heap(RandomAccessIter __first,
               Distance __holeIndex,
-              Distance len, T __val)
+              Distance len, T __val, Compare __comp)
 {
+    static_assert(_Arity >= 2, "a heap needs at least 2 children per node");
+    const Distance arity = Distance(_Arity);
     Distance topIndex = __holeIndex;
-    Distance rightIndex = 2 * __holeIndex + 2; // second child of __holeIndex
-    while(rightIndex < len) {
-        // whether the left child is bigger than right child
-        if(*(__first + rightIndex) < *(__first + rightIndex - 1))
-            --rightIndex;
-        *(__first + __holeIndex) = *(__first + rightIndex);
-        __holeIndex = rightIndex;
-        rightIndex = 2 * rightIndex + 2;
+    Distance child = arity * __holeIndex + 1; // first child of __holeIndex
+    while(child + arity <= len) {
+        // the greatest of the children
+        Distance greatest = child;
+        for(Distance i = child + 1; i < child + arity; ++i)
+            if(__comp(*(__first + greatest), *(__first + i)))
+                greatest = i;
+        *(__first + __holeIndex) = *(__first + greatest);
+        __holeIndex = greatest;
+        child = arity * greatest + 1;
     }
-    if(rightIndex == len) { // only has left child
-        *(__first + __holeIndex) = *(__first + (rightIndex - 1));
-        __holeIndex = rightIndex - 1;
+    if(child < len) { // only has some of the children
+        Distance greatest = child;
+        for(Distance i = child + 1; i < len; ++i)
+            if(__comp(*(__first + greatest), *(__first + i)))
+                greatest = i;
+        *(__first + __holeIndex) = *(__first + greatest);
+        __holeIndex = greatest;
     }
-    *(__first + __holeIndex) = __val;
+    __push_heap<_Arity>(__first, __holeIndex, topIndex, __val, __comp);
 }
 
-template <class RandomAccessIter, class Distance, class T>
+template <size_t _Arity, class RandomAccessIter, class Distance,
+          class T, class Compare>
 inline void
 __pop_heap(RandomAccessIter __first,
            RandomAccessIter __last,
            RandomAccessIter __result,
-           T __val, Distance*)
+           T __val, Compare __comp, Distance*)
 {
     *__result = *__first;
-    __adjust_heap(__first, Distance(0),
-            Distance(__last - __first), __val);
+    __adjust_heap<_Arity>(__first, Distance(0),
+                          Distance(__last - __first), __val, __comp);
 }
 
-template <class RandomAccessIter, class T>
+template <size_t _Arity, class RandomAccessIter, class Compare, class T>
 inline void
 __pop_heap_aux(RandomAccessIter __first,
-         RandomAccessIter __last, T*)
+               RandomAccessIter __last, Compare __comp, T*)
 {
-    __pop_heap(__first, __last-1, __last-1,
-               T(*(__last-1)), __DISTANCE_TYPE(__first));
+    __pop_heap<_Arity>(__first, __last - 1, __last - 1,
+                       T(*(__last - 1)), __comp, __DISTANCE_TYPE(__first));
 }
 
 /**
@@ -105,40 +157,66 @@ __pop_heap_aux(RandomAccessIter __first,
  *          [first, last-1] into a max heap
  * @param   __first, __last: the range of elements to modify
  */
-template <class RandomAccessIter>
+template <size_t _Arity = 2, class RandomAccessIter>
 inline void
 pop_heap(RandomAccessIter __first,
          RandomAccessIter __last)
 {
-    __pop_heap_aux(__first, __last, __VALUE_TYPE(__first));
+    __pop_heap_aux<_Arity>(__first, __last, __heap_less(),
+                           __VALUE_TYPE(__first));
+}
+
+/**
+ * @param   __comp: function object for "less than"
+ */
+template <size_t _Arity = 2, class RandomAccessIter, class Compare>
+inline void
+pop_heap(RandomAccessIter __first,
+         RandomAccessIter __last, Compare __comp)
+{
+    __pop_heap_aux<_Arity>(__first, __last, __comp, __VALUE_TYPE(__first));
 }
 
 /**
  * @brief   Convert the max heap [first, last) into a sorted range
  *          in ascending order
  */
-template <class RandomAccessIter>
+template <size_t _Arity = 2, class RandomAccessIter>
 inline void
 sort_heap(RandomAccessIter __first,
           RandomAccessIter __last)
 {
     while(__last - __first > 1)
-        pop_heap(__first, __last--);
+        pop_heap<_Arity>(__first, __last--);
 }
 
-template <class RandomAccessIter, class Distance, class T>
+/**
+ * @param   __comp: function object for "less than"
+ */
+template <size_t _Arity = 2, class RandomAccessIter, class Compare>
+inline void
+sort_heap(RandomAccessIter __first,
+          RandomAccessIter __last, Compare __comp)
+{
+    while(__last - __first > 1)
+        pop_heap<_Arity>(__first, __last--, __comp);
+}
+
+template <size_t _Arity, class RandomAccessIter, class Compare,
+          class T, class Distance>
 inline void
 __make_heap(RandomAccessIter __first,
             RandomAccessIter __last,
-            T*, Distance*)
+            Compare __comp, T*, Distance*)
 {
     if(__last - __first < 2)
         return;
     Distance len = __last - __first;
-    Distance parent = (len - 2) / 2;
+    Distance parent = (len - 2) / Distance(_Arity);
 
     while(true) {
-        __adjust_heap(__first, parent, len, T(*(__first + parent)));
+        __adjust_heap<_Arity>(__first, parent, len,
+                              T(*(__first + parent)), __comp);
         if(parent == 0)
             return;
         --parent;
@@ -149,13 +227,25 @@ __make_heap(RandomAccessIter __first,
  * @brief   Construct a max heap in the range of [first, last)
  * @param   __first, __last: the range of elements to make the heap form
  */
-template <class RandomAccessIter>
+template <size_t _Arity = 2, class RandomAccessIter>
 inline void
 make_heap(RandomAccessIter __first,
           RandomAccessIter __last)
 {
-    __make_heap(__first, __last, __VALUE_TYPE(__first),
-                __DISTANCE_TYPE(__first));
+    __make_heap<_Arity>(__first, __last, __heap_less(),
+                        __VALUE_TYPE(__first), __DISTANCE_TYPE(__first));
+}
+
+/**
+ * @param   __comp: function object for "less than"
+ */
+template <size_t _Arity = 2, class RandomAccessIter, class Compare>
+inline void
+make_heap(RandomAccessIter __first,
+          RandomAccessIter __last, Compare __comp)
+{
+    __make_heap<_Arity>(__first, __last, __comp,
+                        __VALUE_TYPE(__first), __DISTANCE_TYPE(__first));
 }
 
 } // sstl
@@ -6,11 +6,11 @@
 
 namespace sstl {
 
-#define __ITERATOR_CATEGORY(_Iter)  __iterator_category(_Iter)
-#define __DISTANCE_TYPE(_Iter)      __distance_type(_Iter)
-#define __VALUE_TYPE(_Iter)         __value_type(_Iter)
-#define __DISTANCE(Iter1, Iter2)    __distance(Iter1, Iter2)
-#define __ADVANCE(Iter, n)          __advance(Iter, n)
+#define __ITERATOR_CATEGORY(_Iter)  sstl::__iterator_category(_Iter)
+#define __DISTANCE_TYPE(_Iter)      sstl::__distance_type(_Iter)
+#define __VALUE_TYPE(_Iter)         sstl::__value_type(_Iter)
+#define __DISTANCE(Iter1, Iter2)    sstl::__distance(Iter1, Iter2)
+#define __ADVANCE(Iter, n)          sstl::__advance(Iter, n)
 
 // type of iterator determines the type of distance() and advance()
 struct input_iterator_tag {};       // read-only
@@ -39,11 +39,11 @@ struct __iterator_traits {
  */
 template <class T>
 struct __iterator_traits<T*> {
-    typedef T           value_type;         // type of value
-    typedef T*          iterator_category;  // type of sstl_iterator
-    typedef ptrdiff_t   difference_type;    // type of distance between iterators
-    typedef T*          pointer;            // type of pointer of value
-    typedef T&          reference;          // type of reference of value
+    typedef T                           value_type;         // type of value
+    typedef random_access_iterator_tag  iterator_category;  // type of sstl_iterator
+    typedef ptrdiff_t                   difference_type;    // type of distance between iterators
+    typedef T*                          pointer;            // type of pointer of value
+    typedef T&                          reference;          // type of reference of value
 };
 
 /**
@@ -51,11 +51,11 @@ struct __iterator_traits<T*> {
  */
 template <class T>
 struct __iterator_traits<const T*> {
-    typedef T           value_type;
-    typedef T*          iterator_category;
-    typedef ptrdiff_t   difference_type;
-    typedef T*          pointer_type;
-    typedef T&          reference_type;
+    typedef T                           value_type;
+    typedef random_access_iterator_tag  iterator_category;
+    typedef ptrdiff_t                   difference_type;
+    typedef const T*                    pointer;
+    typedef const T&                    reference;
 };
 
 
@@ -91,21 +91,14 @@ __value_type(const Iter&)
 }
 
 /**
- * @brief   return the distance between two iterators
+ * @brief   Count the steps from first to last, for any category
+ *          other than random access, including the std tags
  */
-template <class Iter> inline auto
-__distance(Iter first, Iter last)
+template <class Iter, class Category> inline auto
+__distance_aux(Iter first, Iter last, Category)
 -> typename __iterator_traits<Iter>::difference_type
 {
-    typedef typename __iterator_traits<Iter>::iterator_category Category;
-    return __distance_aux(first, last, Category());
-}
-
-template <class InputIter> inline auto
-__distance_aux(InputIter first, InputIter last, input_iterator_tag)
--> typename __iterator_traits<InputIter>::difference_type
-{
-    typename __iterator_traits<InputIter>::difference_type n = 0;
+    typename __iterator_traits<Iter>::difference_type n = 0;
     while (first != last) {
         ++n;
         ++first;
@@ -121,12 +114,14 @@ __distance_aux(RandomAccessIter first, RandomAccessIter last, random_access_iter
 }
 
 /**
- * @brief   advances the iterator it by n element positions.
+ * @brief   return the distance between two iterators
  */
-template <class Iter, class Distance> inline void
-__advance(Iter& i, Distance n)
+template <class Iter> inline auto
+__distance(Iter first, Iter last)
+-> typename __iterator_traits<Iter>::difference_type
 {
-    __advance_aux(i, n, __ITERATOR_CATEGORY(i));
+    typedef typename __iterator_traits<Iter>::iterator_category Category;
+    return sstl::__distance_aux(first, last, Category());
 }
 
 template <class InputIter, class Distance> inline void
@@ -150,6 +145,15 @@ __advance_aux(RandomAccessIter& i, Distance n, random_access_iterator_tag)
     i += n;
 }
 
+/**
+ * @brief   advances the iterator it by n element positions.
+ */
+template <class Iter, class Distance> inline void
+__advance(Iter& i, Distance n)
+{
+    sstl::__advance_aux(i, n, __ITERATOR_CATEGORY(i));
+}
+
 /**
  * @brief   Class iterator
  */
@@ -1,6 +1,7 @@
 #ifndef SSTL_LIST_H
 #define SSTL_LIST_H
 
+#include "sstl_config.h"
 #include "sstl_alloc.h"
 #include "sstl_iterator.h"
 #include "sstl_construct.h"
@@ -64,7 +65,7 @@ public:
         return tmp;
     }
 
-protected:
+public:
     _list_node<_Tp>* m_node;
 };
 
@@ -87,15 +88,54 @@ protected:
         return node_allocator::allocate(1);
     }
 
+    /**
+     * @brief   Take a node from the free list of the list,
+     *          or request a new one if the free list is empty
+     */
+    _Node* get_node()
+    {
+        _Node* p = m_free_nodes;
+        if( p == nullptr )
+            return allocate_node();
+        m_free_nodes = p->m_next;
+        --m_free_count;
+        return p;
+    }
+
+    /**
+     * @brief   Keep a node whose value has been destroyed
+     *          in the free list for later reuse
+     */
+    void put_node(_Node* __p)
+    {
+        __p->m_next = m_free_nodes;
+        m_free_nodes = __p;
+        ++m_free_count;
+    }
+
+    /**
+     * @brief   Return all nodes in the free list to the allocator
+     */
+    void release_free_nodes()
+    {
+        while( m_free_nodes != nullptr ) {
+            _Node* next = m_free_nodes->m_next;
+            deallocate_node(m_free_nodes);
+            m_free_nodes = next;
+        }
+        m_free_count = 0;
+    }
+
 public:
     allocator_type get_allocator() const
     { return allocator_type(); }
 
     explicit _list_base(const allocator_type&)
+     : m_free_nodes(nullptr), m_free_count(0)
     {
         m_node = allocate_node();
         m_node->m_next = m_node;
-        m_node->m_next = m_node;
+        m_node->m_prev = m_node;
     }
 
     ~_list_base()
@@ -110,6 +150,7 @@ public:
         m_node->m_next = m_node;
         m_node->m_prev = m_node;
         deallocate_node(m_node);
+        release_free_nodes();
     }
 
     /**
@@ -121,15 +162,35 @@ public:
     /**
      * @brief   Request memory and initiate node with specified value
      */
-    _Node* create_node(const value_type& __val) const
+    _Node* create_node(const value_type& __val)
     {
-        _Node* p = allocate_node();
-        construct(p, __val);
+        _Node* p = get_node();
+        __SSTL_TRY {
+            construct(&p->m_data, __val);
+        }
+    #ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            put_node(p);
+            throw;
+        }
+    #endif
         return p;
     }
 
+    /**
+     * @brief   Destroy the value of a node and keep
+     *          the node for reuse
+     */
+    void destroy_node(_Node* __p)
+    {
+        sstl::destroy(&__p->m_data);
+        put_node(__p);
+    }
+
 protected:
     _Node* m_node;
+    _Node* m_free_nodes; // destroyed nodes kept for reuse
+    size_t m_free_count;
 };
 
 
@@ -153,8 +214,13 @@ public:
 protected:
     typedef _list_node<_Tp> _Node;
     using _Base::m_node;
+    using _Base::m_free_count;
     using _Base::allocate_node;
     using _Base::deallocate_node;
+    using _Base::create_node;
+    using _Base::destroy_node;
+    using _Base::put_node;
+    using _Base::release_free_nodes;
 
 public:
     allocator_type get_allocator()
@@ -166,6 +232,10 @@ public:
     list(const allocator_type& __alloc = allocator_type())
      : _Base(__alloc) {}
 
+    list(const list<_Tp, _Alloc>& __x)
+     : _Base(allocator_type())
+    { insert(begin(), __x.begin(), __x.end()); }
+
     list(size_type __n, const value_type& __val,
          const allocator_type& __alloc = allocator_type())
      : _Base(__alloc)
@@ -180,6 +250,26 @@ public:
      */
     ~list() = default;
 
+    /**
+     * @brief   Replace the contents with a copy of __x, assigning
+     *          into the existing nodes before creating new ones
+     */
+    list<_Tp, _Alloc>& operator=(const list<_Tp, _Alloc>& __x)
+    {
+        if( this == &__x )
+            return *this;
+
+        iterator first1 = begin();
+        const_iterator first2 = __x.begin();
+        for( ; first1 != end() && first2 != __x.end(); ++first1, ++first2)
+            *first1 = *first2;
+        if( first2 == __x.end() )
+            erase(first1, end());
+        else
+            insert(end(), first2, __x.end());
+        return *this;
+    }
+
     /**
      * @brief   Return an iterator to the first element of list
      */
@@ -206,7 +296,7 @@ public:
     /**
      * @brief   Check whether the list is empty
      */
-    bool empty() const { return m_node->next == m_node; }
+    bool empty() const { return m_node->m_next == m_node; }
 
     /**
      * @brief   Return a reference to the first element
@@ -303,8 +393,7 @@ public:
         _Node* prev_node = t_node->m_prev;
         prev_node->m_next = next_node;
         next_node->m_prev = prev_node;
-        sstl::destroy(t_node->m_data);
-        deallocate_node(t_node);
+        destroy_node(t_node);
         return next_node;
     }
 
@@ -313,13 +402,32 @@ public:
      */
     iterator erase(iterator __first, iterator __last)
     {
-        while( __first != __last ) {
-            erase(__first);
-            ++__first;
-        }
+        while( __first != __last )
+            __first = erase(__first);
         return __last;
     }
 
+    /**
+     * @brief   Erase all elements, keeping their nodes for reuse
+     */
+    void clear() { erase(begin(), end()); }
+
+    /**
+     * @brief   Make sure that __n elements can be held without
+     *          requesting nodes from the allocator
+     * @param   __n: number of elements to hold
+     */
+    void reserve_nodes(size_type __n)
+    {
+        for(size_type held = size() + m_free_count; held < __n; ++held)
+            put_node(allocate_node());
+    }
+
+    /**
+     * @brief   Return the nodes kept for reuse to the allocator
+     */
+    void release_nodes() { release_free_nodes(); }
+
     /**
      * @brief   Remove the first element
      */
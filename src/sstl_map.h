@@ -65,6 +65,20 @@ public:
         _Compare __comp): m_rb(__comp)
     { m_rb.insert_unique(__first, __last); }
 
+    /**
+     * @brief   Construct the map in linear time from a range which
+     *          is sorted by key and free of duplicate keys
+     */
+    template <class ForwardIter>
+    map(from_sorted_t, ForwardIter __first, ForwardIter __last)
+     : m_rb(_Compare())
+    { m_rb.assign_sorted(__first, __last); }
+
+    template <class ForwardIter>
+    map(from_sorted_t, ForwardIter __first, ForwardIter __last,
+        _Compare __comp): m_rb(__comp)
+    { m_rb.assign_sorted(__first, __last); }
+
     map(const map<_Key, _Value, _Compare, _Alloc>& __x)
      : m_rb(__x.m_rb) {}
 
@@ -127,14 +141,30 @@ public:
      */
     mapped_type& operator[](const key_type& __k)
     {
-        return (insert(value_type(__k, mapped_type()))->first).second;
+        return insert(value_type(__k, mapped_type())).first->second;
     }
 
     /**
      * @brief   Exchange contents of the container with other
      */
     void swap(map<_Key, _Value, _Compare, _Alloc>& __x)
-    { m_rb.swap(__x.t); }
+    { m_rb.swap(__x.m_rb); }
+
+    /**
+     * @brief   Move the elements whose keys are not less than __k
+     *          to __right in O(log n) time, replacing its contents
+     */
+    void split(const key_type& __k,
+               map<_Key, _Value, _Compare, _Alloc>& __right)
+    { m_rb.split(__k, __right.m_rb); }
+
+    /**
+     * @brief   Move all elements of __right to the end of the
+     *          container in O(log n) time, every key of __right
+     *          must be greater than the keys in the container
+     */
+    void join(map<_Key, _Value, _Compare, _Alloc>& __right)
+    { m_rb.join(__right.m_rb); }
 
     /**
      * @brief   Insert element into the container if the container
@@ -144,6 +174,11 @@ public:
     pair<iterator, bool> insert(const value_type& __val)
     { return m_rb.insert_unique(__val); }
 
+    /**
+     * @param   __pos: iterator to the position before which the
+     *          element is expected to be inserted, end() makes
+     *          appending increasing keys amortized constant time
+     */
     iterator insert(iterator __pos, const value_type& __val)
     { return m_rb.insert_unique(__pos, __val); }
 
@@ -219,6 +254,29 @@ public:
     equal_range(const key_type& __k) const
     { return m_rb.equal_range(__k); }
 
+    /**
+     * @brief   Return an iterator to the element with index __k
+     *          in ascending order of keys, or end() if there is none
+     * @param   __k: zero-based index of the element
+     */
+    iterator nth(size_type __k) { return m_rb.nth(__k); }
+
+    const_iterator nth(size_type __k) const { return m_rb.nth(__k); }
+
+    /**
+     * @brief   Return the number of elements whose key is less than key
+     * @param   __k: key value to compare the elements to
+     */
+    size_type rank(const key_type& __k) const { return m_rb.rank(__k); }
+
+    /**
+     * @brief   Return the number of elements in [__first, __last)
+     * @param   __first, __last: range of elements in the container
+     */
+    difference_type distance(const_iterator __first,
+                             const_iterator __last) const
+    { return m_rb.distance(__first, __last); }
+
     friend inline bool
     operator==(const map<_Key, _Value, _Compare, _Alloc>& __x,
                const map<_Key, _Value, _Compare, _Alloc>& __y)
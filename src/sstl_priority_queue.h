@@ -4,22 +4,50 @@
 #include "sstl_config.h"
 #include "sstl_heap.h"
 #include "sstl_vector.h"
+#include "sstl_algobase.h"
 
 
 namespace sstl {
 
+/**
+ * @brief   Max heap of elements kept in _Sequence. _Arity is the
+ *          number of children of each node of the heap, see
+ *          sstl_heap.h: 4 or 8 make push cheaper and pop dearer
+ */
 template <class _Tp, class _Sequence = sstl::vector<_Tp>,
-          class Compare = std::less<typename _Sequence::value_type>>
+          class Compare = std::less<typename _Sequence::value_type>,
+          size_t _Arity = 2>
 class priority_queue {
+    static_assert(_Arity >= 2, "a heap needs at least 2 children per node");
+
 public:
-    typedef typename _Sequence::value_type  value_type;
-    typedef typename _Sequence::size_type   size_type;
-    typedef typename _Sequence::reference   reference;
+    typedef typename _Sequence::value_type      value_type;
+    typedef typename _Sequence::size_type       size_type;
+    typedef typename _Sequence::reference       reference;
+    typedef typename _Sequence::const_reference const_reference;
 
 protected:
     _Sequence m_seq;
     Compare m_comp;
 
+    /**
+     * @brief   Make a heap of m_seq whose first __n elements are a heap,
+     *          pushing the others one at a time, or rebuilding the whole
+     *          heap when they are at least as many as the heap. Each push
+     *          costs up to log(n) moves, but few for random values, so
+     *          rebuilding only wins for large batches, or for batches of
+     *          values greater than those already in the heap
+     */
+    void _heapify_tail(size_type __n)
+    {
+        if(m_seq.size() - __n >= __n) {
+            make_heap<_Arity>(m_seq.begin(), m_seq.end(), m_comp);
+            return;
+        }
+        for(size_type i = __n + 1; i <= m_seq.size(); ++i)
+            push_heap<_Arity>(m_seq.begin(), m_seq.begin() + i, m_comp);
+    }
+
 public:
     /**
      * @brief   Construct new underlying container
@@ -41,14 +69,14 @@ public:
                    const Compare& __comp)
      : m_seq(__first, __last), m_comp(__comp)
     {
-        make_heap(m_seq.begin(), m_seq.end(), m_comp);
+        make_heap<_Arity>(m_seq.begin(), m_seq.end(), m_comp);
     }
 
     template <class InputIter>
     priority_queue(InputIter __first, InputIter __last)
      : m_seq(__first, __last)
     {
-        make_heap(m_seq.begin(), m_seq.end(), m_comp);
+        make_heap<_Arity>(m_seq.begin(), m_seq.end(), m_comp);
     }
 
     /**
@@ -65,6 +93,7 @@ public:
      * @brief   Return reference to the top element
      */
     reference top() { return m_seq.front(); }
+    const_reference top() const { return m_seq.front(); }
 
     /**
      * @brief   Push the given element value
@@ -74,19 +103,84 @@ public:
     {
         __SSTL_TRY {
             m_seq.push_back(__val);
-            push_heap(m_seq.begin(), m_seq.end(), m_comp);
+            push_heap<_Arity>(m_seq.begin(), m_seq.end(), m_comp);
         }
 #ifdef __SSTL_USE_EXCEPTIONS
         catch (...) { }
 #endif
     };
 
+    /**
+     * @brief   Push the elements of [__first, __last), appending them
+     *          all before restoring the heap, see _heapify_tail. If
+     *          copying an element throws, the appended elements are
+     *          removed and the exception is rethrown. If comparing or
+     *          copying throws while the heap is restored, elements may
+     *          already be lost, so the queue is emptied before the
+     *          exception is rethrown, leaving no broken heap behind
+     * @param   __first, __last: range of elements to push
+     */
+    template <class InputIter>
+    void push_range(InputIter __first, InputIter __last)
+    {
+        const size_type n = m_seq.size();
+        __SSTL_TRY {
+            for(; __first != __last; ++__first)
+                m_seq.push_back(*__first);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            m_seq.erase(m_seq.begin() + n, m_seq.end());
+            throw;
+        }
+#endif
+        __SSTL_TRY {
+            _heapify_tail(n);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            m_seq.clear();
+            throw;
+        }
+#endif
+    }
+
+    /**
+     * @brief   Move all elements of __x into this queue, leaving __x
+     *          empty. The smaller queue is pushed into the larger one,
+     *          so queues filled separately, e.g. by worker threads,
+     *          can be combined once the threads are done with them.
+     *          If push_range throws, the queues get their contents
+     *          back, except that the larger one is empty if its heap
+     *          could not be restored
+     * @param   __x: queue to take the elements of
+     */
+    void merge(priority_queue& __x)
+    {
+        if(this == &__x)
+            return;
+        const bool swapped = m_seq.size() < __x.m_seq.size();
+        if(swapped)
+            m_seq.swap(__x.m_seq);
+        __SSTL_TRY {
+            push_range(__x.m_seq.begin(), __x.m_seq.end());
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            if(swapped)
+                m_seq.swap(__x.m_seq);
+            throw;
+        }
+#endif
+        __x.m_seq.clear();
+    }
+
     /**
      * @brief   Remove the top element
      */
     void pop() {
         __SSTL_TRY {
-            pop_heap(m_seq.begin(), m_seq.end(), m_comp);
+            pop_heap<_Arity>(m_seq.begin(), m_seq.end(), m_comp);
             m_seq.pop_back();
         }
 #ifdef __SSTL_USE_EXCEPTIONS
@@ -95,6 +189,267 @@ public:
     };
 };
 
+/**
+ * @brief   Priority queue whose elements can be changed or removed
+ *          after being pushed, through the handle push returns, as
+ *          needed by Dijkstra's or Prim's algorithm. It is a d-ary
+ *          max heap like priority_queue, each entry holding its
+ *          value and handle, with a table from handles to heap
+ *          positions which is kept up to date as entries move.
+ *          A handle is valid until its element is popped or erased,
+ *          after which it may be given to a new element
+ */
+template <class _Tp,
+          class Compare = std::less<_Tp>,
+          size_t _Arity = 4,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class addressable_priority_queue {
+    static_assert(_Arity >= 2, "a heap needs at least 2 children per node");
+
+public:
+    typedef _Tp         value_type;
+    typedef size_t      size_type;
+    typedef const _Tp&  const_reference;
+    typedef size_t      handle_type;
+
+private:
+    struct _Entry {
+        _Tp value;
+        handle_type handle;
+
+        _Entry(const _Tp& __v, handle_type __h): value(__v), handle(__h) {}
+    };
+
+    static const size_type __npos = size_type(-1);
+
+    vector<_Entry, _Alloc> m_heap;
+    vector<size_type, _Alloc> m_pos;        // heap position of each handle
+    vector<handle_type, _Alloc> m_free;     // handles not in use
+    Compare m_comp;
+
+    void _place(size_type __i, const _Entry& __e)
+    {
+        m_heap[__i] = __e;
+        m_pos[__e.handle] = __i;
+    }
+
+    /**
+     * @brief   Move the entry at __i up while its parent is less
+     */
+    void _sift_up(size_type __i)
+    {
+        const _Entry e = m_heap[__i];
+        while(__i > 0) {
+            const size_type parent = (__i - 1) / _Arity;
+            if(!m_comp(m_heap[parent].value, e.value))
+                break;
+            _place(__i, m_heap[parent]);
+            __i = parent;
+        }
+        _place(__i, e);
+    }
+
+    /**
+     * @brief   Move the entry at __i down while a child is greater
+     */
+    void _sift_down(size_type __i)
+    {
+        const size_type n = m_heap.size();
+        const _Entry e = m_heap[__i];
+        for(;;) {
+            const size_type child = _Arity * __i + 1;
+            if(child >= n)
+                break;
+            const size_type last = sstl::min(child + _Arity, n);
+            size_type greatest = child;
+            for(size_type c = child + 1; c < last; ++c)
+                if(m_comp(m_heap[greatest].value, m_heap[c].value))
+                    greatest = c;
+            if(!m_comp(e.value, m_heap[greatest].value))
+                break;
+            _place(__i, m_heap[greatest]);
+            __i = greatest;
+        }
+        _place(__i, e);
+    }
+
+    /**
+     * @brief   Remove the entry at __i
+     */
+    void _remove(size_type __i)
+    {
+        m_free.push_back(m_heap[__i].handle);
+        m_pos[m_heap[__i].handle] = __npos;
+        const size_type last = m_heap.size() - 1;
+        if(__i != last) {
+            _place(__i, m_heap[last]);
+            m_heap.pop_back();
+            _fix(__i);
+        } else {
+            m_heap.pop_back();
+        }
+    }
+
+    /**
+     * @brief   Restore the heap around __i after its value changed
+     */
+    void _fix(size_type __i)
+    {
+        if(__i > 0 && m_comp(m_heap[(__i - 1) / _Arity].value, m_heap[__i].value))
+            _sift_up(__i);
+        else
+            _sift_down(__i);
+    }
+
+public:
+    addressable_priority_queue(): m_heap(), m_pos(), m_free(), m_comp() {}
+
+    /**
+     * @param   __comp: the comparison function object, the greatest
+     *          element by __comp is on top
+     */
+    explicit addressable_priority_queue(const Compare& __comp)
+     : m_heap(), m_pos(), m_free(), m_comp(__comp) {}
+
+    /**
+     * @brief   Check whether the queue is empty
+     */
+    bool empty() const { return m_heap.empty(); }
+
+    /**
+     * @brief   Return the number of elements
+     */
+    size_type size() const { return m_heap.size(); }
+
+    /**
+     * @brief   Make room for __n elements
+     */
+    void reserve(size_type __n)
+    {
+        m_heap.reserve(__n);
+        m_pos.reserve(__n);
+    }
+
+    /**
+     * @brief   Return the top element
+     */
+    const_reference top() const { return m_heap.front().value; }
+
+    /**
+     * @brief   Return the handle of the top element
+     */
+    handle_type top_handle() const { return m_heap.front().handle; }
+
+    /**
+     * @brief   Return the value of the element with handle __h
+     */
+    const_reference value(handle_type __h) const
+    { return m_heap[m_pos[__h]].value; }
+
+    /**
+     * @brief   Check whether __h is the handle of an element
+     */
+    bool contains(handle_type __h) const
+    { return __h < m_pos.size() && m_pos[__h] != __npos; }
+
+    /**
+     * @brief   Push the given element value
+     * @param   __val: the value of element to push
+     * @return  the handle of the element
+     */
+    handle_type push(const value_type& __val)
+    {
+        const bool reuse = !m_free.empty();
+        const handle_type h = reuse ? m_free.back() : m_pos.size();
+        if(!reuse)
+            m_pos.push_back(__npos);
+        __SSTL_TRY {
+            m_heap.push_back(_Entry(__val, h));
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            if(!reuse)
+                m_pos.pop_back();
+            throw;
+        }
+#endif
+        if(reuse)
+            m_free.pop_back();
+        m_pos[h] = m_heap.size() - 1;
+        _sift_up(m_heap.size() - 1);
+        return h;
+    }
+
+    /**
+     * @brief   Remove the top element
+     */
+    void pop() { _remove(0); }
+
+    /**
+     * @brief   Remove the element with handle __h
+     */
+    void erase(handle_type __h) { _remove(m_pos[__h]); }
+
+    /**
+     * @brief   Give the element with handle __h the value __val,
+     *          which may be greater or less than its value
+     */
+    void update(handle_type __h, const value_type& __val)
+    {
+        const size_type i = m_pos[__h];
+        m_heap[i].value = __val;
+        _fix(i);
+    }
+
+    /**
+     * @brief   Give the element with handle __h the value __val,
+     *          which must not be less than its value by Compare,
+     *          so the element moves towards the top. With
+     *          sstl::greater, for a min queue as in Dijkstra's
+     *          algorithm, this lowers the value
+     */
+    void increase_key(handle_type __h, const value_type& __val)
+    {
+        const size_type i = m_pos[__h];
+        m_heap[i].value = __val;
+        _sift_up(i);
+    }
+
+    /**
+     * @brief   Give the element with handle __h the value __val,
+     *          which must not be greater than its value by Compare,
+     *          so the element moves away from the top
+     */
+    void decrease_key(handle_type __h, const value_type& __val)
+    {
+        const size_type i = m_pos[__h];
+        m_heap[i].value = __val;
+        _sift_down(i);
+    }
+
+    /**
+     * @brief   Remove all elements, all handles become invalid
+     */
+    void clear()
+    {
+        m_heap.clear();
+        m_pos.clear();
+        m_free.clear();
+    }
+
+    void swap(addressable_priority_queue& __x)
+    {
+        m_heap.swap(__x.m_heap);
+        m_pos.swap(__x.m_pos);
+        m_free.swap(__x.m_free);
+        sstl::swap(m_comp, __x.m_comp);
+    }
+};
+
+template <class _Tp, class Compare, size_t _Arity, class _Alloc>
+const typename addressable_priority_queue<_Tp, Compare, _Arity, _Alloc>::size_type
+addressable_priority_queue<_Tp, Compare, _Arity, _Alloc>::__npos;
+
 } // sstl
 
 
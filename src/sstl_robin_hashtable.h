@@ -0,0 +1,623 @@
+#ifndef SSTL_ROBIN_HASHTABLE_H
+#define SSTL_ROBIN_HASHTABLE_H
+
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include "sstl_config.h"
+#include "sstl_iterator.h"
+#include "sstl_alloc.h"
+#include "sstl_construct.h"
+#include "sstl_algobase.h"
+#include "sstl_functional.h"
+#include "sstl_hashtable.h"
+#include "sstl_flat_hashtable.h"
+#include "sstl_pair.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Open addressing hashtable with unique keys and linear
+ *          probing, where an insert takes the slot of any value that
+ *          is closer to its home slot than the new one ("robin hood").
+ *          So the values of a run are ordered by home slot, and one
+ *          byte per slot holding the distance of its value from home
+ *          lets a lookup stop as soon as it meets a value closer to
+ *          home than the key would be, which keeps missed lookups
+ *          short even at a 0.9 load factor. Erasing shifts the values
+ *          after the slot back by one instead of leaving a tombstone.
+ *
+ *          The probes never wrap around: the capacity is a power of
+ *          two followed by __max_dist overflow slots, and the table
+ *          grows when a value would be further than that from home.
+ *          Growing can't separate keys with equal hash values, so the
+ *          table grows at most __max_growth times beyond the capacity
+ *          its size needs, and an insert which still doesn't fit
+ *          throws length_error, leaving the table unchanged. About
+ *          __max_dist keys with one hash value fit. Inserting or
+ *          erasing may invalidate all iterators
+ */
+template <class _Key, class _Value,
+          class _HashFunc = std::hash<_Key>,
+          class _ExtractKey = sstl::identity<_Key>,
+          class _EqualKey = sstl::equal_to<_Key>,
+          class _Alloc = __SSTL_DEFAULT_ALLOC>
+class robin_hashtable {
+public:
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef _Value* pointer;
+
+    typedef const _Value* const_pointer;
+    typedef _Value& reference;
+    typedef const _Value& const_reference;
+
+    // the distance bytes use the empty and sentinel
+    // values of flat_hashtable, so its iterators fit
+    typedef __flat_hashtable_iterator<_Value, _Value&, _Value*> iterator;
+    typedef __flat_hashtable_iterator<_Value, const _Value&, const _Value*>
+            const_iterator;
+
+    typedef _HashFunc hasher;
+    typedef _EqualKey key_equal;
+
+    typedef _Alloc allocator_type;
+
+private:
+    typedef __SSTL_ALLOC(_Value, _Alloc) slot_allocator;
+    typedef __SSTL_ALLOC(signed char, _Alloc) dist_allocator;
+    typedef typename __type_traits<_Value>::is_POD_type _Is_POD;
+
+    enum {
+        __max_dist = 128,   // a distance fits a signed char
+        __max_growth = 3    // doublings beyond the capacity for the size
+    };
+
+private:
+    hasher m_hash;
+    key_equal m_equal;
+    _ExtractKey m_getKey;
+
+    signed char* m_dist;    // distance from home, or __flat_empty
+    _Value* m_slots;
+    size_type m_capacity;   // 0 or a power of two, the home slots
+    size_type m_max_dist;   // overflow slots after the home slots
+    size_type m_size;
+
+    static const signed char* _empty_dist()
+    {
+        static const signed char sentinel = __flat_sentinel;
+        return &sentinel;
+    }
+
+    /**
+     * @brief   Return the number of slots, including
+     *          the overflow slots but not the sentinel
+     */
+    size_type _slot_count() const { return m_capacity + m_max_dist; }
+
+    /**
+     * @brief   Return the number of values the
+     *          capacity __n holds before growing
+     */
+    static size_type _growth_limit(size_type __n)
+    { return __n - __n / 10; }
+
+    size_type _hash(const key_type& __k) const
+    { return __hash_mix(m_hash(__k)); }
+
+    size_type _home(size_type __h) const
+    { return __h & (m_capacity - 1); }
+
+    /**
+     * @brief   Return the index of the slot holding key __k whose
+     *          hash is __h, or _slot_count() if there is none
+     */
+    size_type _find(const key_type& __k, size_type __h) const
+    {
+        if(m_capacity == 0)
+            return 0;
+        size_type i = _home(__h);
+        // the values of the run closer to home than d can't be __k,
+        // neither can anything after them
+        for(int d = 0; m_dist[i] >= d; ++i, ++d)
+            if(m_dist[i] == d && m_equal(m_getKey(m_slots[i]), __k))
+                return i;
+        return _slot_count();
+    }
+
+    /**
+     * @brief   Put a copy of __val in slot __i, moving the values of
+     *          slots [__i, __e) one slot up, slot __e being free. POD
+     *          values are moved as raw bytes. The others are copied to
+     *          slot __e first and swapped down to __i, and if a copy or
+     *          a swap throws the swaps are undone, leaving the slots
+     *          unchanged as long as undoing a swap doesn't throw
+     */
+    void _insert_slot(size_type __i, size_type __e,
+                      const value_type& __val, __true_type)
+    {
+        memmove(m_slots + __i + 1, m_slots + __i,
+                (__e - __i) * sizeof(_Value));
+        sstl::construct(m_slots + __i, __val);
+    }
+
+    void _insert_slot(size_type __i, size_type __e,
+                      const value_type& __val, __false_type)
+    {
+        sstl::construct(m_slots + __e, __val);
+        size_type k = __e;
+        __SSTL_TRY {
+            for(; k > __i; --k)
+                std::swap(m_slots[k], m_slots[k - 1]);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            for(; k < __e; ++k)
+                std::swap(m_slots[k], m_slots[k + 1]);
+            sstl::destroy(m_slots + __e);
+            throw;
+        }
+#endif
+    }
+
+    /**
+     * @brief   Destroy the value of slot __i, moving the values of
+     *          slots (__i, __e] one slot down, the same way
+     */
+    void _remove_slot(size_type __i, size_type __e, __true_type)
+    {
+        sstl::destroy(m_slots + __i);
+        memmove(m_slots + __i, m_slots + __i + 1,
+                (__e - __i) * sizeof(_Value));
+    }
+
+    void _remove_slot(size_type __i, size_type __e, __false_type)
+    {
+        size_type k = __i;
+        __SSTL_TRY {
+            for(; k < __e; ++k)
+                std::swap(m_slots[k], m_slots[k + 1]);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            for(; k > __i; --k)
+                std::swap(m_slots[k], m_slots[k - 1]);
+            throw;
+        }
+#endif
+        sstl::destroy(m_slots + __e);
+    }
+
+    /**
+     * @brief   Put a copy of __val whose hash is __h in its slot,
+     *          shifting the richer values after it by one slot
+     * @return  The slot of the value, or _slot_count() if some
+     *          value would be __max_dist slots from home or more
+     */
+    size_type _place(const value_type& __val, size_type __h)
+    {
+        const int limit = (int)m_max_dist;
+        size_type i = _home(__h);
+        int d = 0;
+        for(; m_dist[i] >= d; ++i)
+            ++d;
+        if(d >= limit)
+            return _slot_count();
+
+        size_type e = i;
+        for(; m_dist[e] != __flat_empty; ++e)
+            if(m_dist[e] + 1 >= limit)
+                return _slot_count();
+
+        _insert_slot(i, e, __val, _Is_POD());
+        memmove(m_dist + i + 1, m_dist + i, e - i);
+        for(size_type k = i + 1; k <= e; ++k)
+            ++m_dist[k];
+        m_dist[i] = (signed char)d;
+        return i;
+    }
+
+    /**
+     * @brief   Destroy the value in slot __i and move the values
+     *          after it which are not at home back by one slot
+     */
+    void _erase_slot(size_type __i)
+    {
+        size_type e = __i + 1;
+        while(m_dist[e] > 0)
+            ++e;
+        _remove_slot(__i, e - 1, _Is_POD());
+        memmove(m_dist + __i, m_dist + __i + 1, e - 1 - __i);
+        for(size_type k = __i; k < e - 1; ++k)
+            --m_dist[k];
+        m_dist[e - 1] = __flat_empty;
+        --m_size;
+    }
+
+    static void _throw_too_many_collisions()
+    {
+#ifdef __SSTL_USE_EXCEPTIONS
+        throw std::length_error("robin_hashtable: too many equal hash values");
+#else
+        std::abort();
+#endif
+    }
+
+    /**
+     * @brief   Allocate the arrays for __n home slots, all empty. The
+     *          members are only set once both allocations succeed,
+     *          so on failure the table keeps its arrays
+     */
+    void _allocate(size_type __n)
+    {
+        const size_type max_dist = sstl::min(__n, size_type(__max_dist));
+        signed char* dist = dist_allocator::allocate(__n + max_dist + 1);
+        _Value* slots = nullptr;
+        __SSTL_TRY {
+            slots = slot_allocator::allocate(__n + max_dist);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            dist_allocator::deallocate(dist, __n + max_dist + 1);
+            throw;
+        }
+#endif
+        sstl::fill(dist, dist + __n + max_dist, (signed char)__flat_empty);
+        dist[__n + max_dist] = __flat_sentinel;
+        m_dist = dist;
+        m_slots = slots;
+        m_capacity = __n;
+        m_max_dist = max_dist;
+    }
+
+    void _deallocate()
+    {
+        if(m_capacity != 0) {
+            dist_allocator::deallocate(m_dist, _slot_count() + 1);
+            slot_allocator::deallocate(m_slots, _slot_count());
+        }
+        m_dist = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_max_dist = 0;
+    }
+
+    /**
+     * @brief   Destroy all values, leaving the slots empty
+     */
+    void _destroy_values()
+    {
+        for(size_type i = 0; i < _slot_count(); ++i)
+            if(m_dist[i] >= 0) {
+                sstl::destroy(m_slots + i);
+                m_dist[i] = __flat_empty;
+            }
+    }
+
+    /**
+     * @brief   Move the values to new arrays of at least __n home
+     *          slots, doubling them up to __max_growth times until
+     *          every value fits. If an allocation or copying a value
+     *          throws, or the values still don't fit, the table is
+     *          left unchanged
+     */
+    void _rehash(size_type __n)
+    {
+        signed char* old_dist = m_dist;
+        _Value* old_slots = m_slots;
+        const size_type old_n = m_capacity;
+        const size_type old_max_dist = m_max_dist;
+        const size_type old_count = old_n + old_max_dist;
+
+        // the members hold the old arrays whenever _allocate is
+        // called, and get them back after each failed attempt
+        bool fits = false;
+        for(int tries = 0; !fits && tries <= __max_growth; ++tries, __n *= 2) {
+            _allocate(__n);
+            fits = true;
+            __SSTL_TRY {
+                for(size_type i = 0; fits && i < old_count; ++i)
+                    if(old_dist[i] >= 0)
+                        fits = _place(old_slots[i],
+                                      _hash(m_getKey(old_slots[i])))
+                               != _slot_count();
+            }
+#ifdef __SSTL_USE_EXCEPTIONS
+            catch(...) {
+                _destroy_values();
+                _deallocate();
+                m_dist = old_dist;
+                m_slots = old_slots;
+                m_capacity = old_n;
+                m_max_dist = old_max_dist;
+                throw;
+            }
+#endif
+            if(!fits) {
+                _destroy_values();
+                _deallocate();
+                m_dist = old_dist;
+                m_slots = old_slots;
+                m_capacity = old_n;
+                m_max_dist = old_max_dist;
+            }
+        }
+        if(!fits)
+            _throw_too_many_collisions();
+
+        for(size_type i = 0; i < old_count; ++i)
+            if(old_dist[i] >= 0)
+                sstl::destroy(old_slots + i);
+        if(old_n != 0) {
+            dist_allocator::deallocate(old_dist, old_count + 1);
+            slot_allocator::deallocate(old_slots, old_count);
+        }
+    }
+
+    /**
+     * @brief   Return the smallest capacity which holds __n values
+     */
+    static size_type _capacity_for(size_type __n)
+    {
+        size_type cap = 8;
+        while(_growth_limit(cap) < __n)
+            cap *= 2;
+        return cap;
+    }
+
+    /**
+     * @brief   Copy the values of __ht to the same slots
+     */
+    void _copy_from(const robin_hashtable& __ht)
+    {
+        if(__ht.m_size == 0)
+            return;
+        _allocate(__ht.m_capacity);
+        for(size_type i = 0; i < __ht._slot_count(); ++i) {
+            if(__ht.m_dist[i] < 0)
+                continue;
+            sstl::construct(m_slots + i, __ht.m_slots[i]);
+            m_dist[i] = __ht.m_dist[i];
+            ++m_size;
+        }
+    }
+
+    iterator _make_iter(size_type __i)
+    { return iterator(m_dist + __i, m_slots + __i); }
+
+public:
+    robin_hashtable(size_type __n,
+                    const _HashFunc& __hf,
+                    const _EqualKey& __eql)
+     : m_hash(__hf), m_equal(__eql), m_getKey(_ExtractKey()),
+       m_dist(nullptr), m_slots(nullptr), m_capacity(0),
+       m_max_dist(0), m_size(0)
+    {
+        if(__n != 0)
+            _allocate(_capacity_for(__n));
+    }
+
+    robin_hashtable(const robin_hashtable& __ht)
+     : m_hash(__ht.m_hash), m_equal(__ht.m_equal),
+       m_getKey(__ht.m_getKey), m_dist(nullptr), m_slots(nullptr),
+       m_capacity(0), m_max_dist(0), m_size(0)
+    {
+        __SSTL_TRY {
+            _copy_from(__ht);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            _destroy_values();
+            _deallocate();
+            throw;
+        }
+#endif
+    }
+
+    ~robin_hashtable()
+    {
+        _destroy_values();
+        _deallocate();
+    }
+
+    robin_hashtable& operator=(const robin_hashtable& __ht)
+    {
+        if(this != &__ht) {
+            robin_hashtable tmp(__ht);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    { return allocator_type(); }
+
+    hasher hash_func() const { return m_hash; }
+
+    key_equal key_eq() const { return m_equal; }
+
+    size_type size() const { return m_size; }
+
+    size_type max_size() const { return size_type(-1) / sizeof(_Value); }
+
+    bool empty() const { return m_size == 0; }
+
+    void swap(robin_hashtable& __ht)
+    {
+        sstl::swap(m_hash, __ht.m_hash);
+        sstl::swap(m_equal, __ht.m_equal);
+        sstl::swap(m_getKey, __ht.m_getKey);
+        sstl::swap(m_dist, __ht.m_dist);
+        sstl::swap(m_slots, __ht.m_slots);
+        sstl::swap(m_capacity, __ht.m_capacity);
+        sstl::swap(m_max_dist, __ht.m_max_dist);
+        sstl::swap(m_size, __ht.m_size);
+    }
+
+    iterator begin()
+    {
+        if(m_capacity == 0)
+            return end();
+        iterator it = _make_iter(0);
+        it.skip_free();
+        return it;
+    }
+
+    const_iterator begin() const
+    { return const_cast<robin_hashtable*>(this)->begin(); }
+
+    iterator end()
+    {
+        if(m_capacity == 0)
+            return iterator(_empty_dist(), nullptr);
+        return _make_iter(_slot_count());
+    }
+
+    const_iterator end() const
+    { return const_cast<robin_hashtable*>(this)->end(); }
+
+    /**
+     * @brief   Insert element if the container doesn't contain
+     *          an element with an equivalent key
+     * @param   __val: element value to insert
+     */
+    pair<iterator, bool> insert_unique(const value_type& __val)
+    {
+        const size_type h = _hash(m_getKey(__val));
+        size_type i = _find(m_getKey(__val), h);
+        if(i != _slot_count())
+            return pair<iterator, bool>(_make_iter(i), false);
+
+        if(m_size >= _growth_limit(m_capacity))
+            _rehash(_capacity_for(m_size + 1));
+        // only keys with many equal hash values need to grow further
+        const size_type max_capacity =
+                _capacity_for(m_size + 1) << int(__max_growth);
+        while((i = _place(__val, h)) == _slot_count()) {
+            if(m_capacity >= max_capacity)
+                _throw_too_many_collisions();
+            _rehash(m_capacity * 2);
+        }
+        ++m_size;
+        return pair<iterator, bool>(_make_iter(i), true);
+    }
+
+    template <class _InputIter>
+    void insert_unique(_InputIter __first, _InputIter __last)
+    {
+        for(; __first != __last; ++__first)
+            insert_unique(*__first);
+    }
+
+    iterator find(const key_type& __k)
+    {
+        size_type i = _find(__k, _hash(__k));
+        return i == _slot_count() ? end() : _make_iter(i);
+    }
+
+    const_iterator find(const key_type& __k) const
+    { return const_cast<robin_hashtable*>(this)->find(__k); }
+
+    size_type count(const key_type& __k) const
+    { return _find(__k, _hash(__k)) == _slot_count() ? 0 : 1; }
+
+    pair<iterator, iterator> equal_range(const key_type& __k)
+    {
+        iterator first = find(__k), last = first;
+        if(first != end())
+            ++last;
+        return pair<iterator, iterator>(first, last);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& __k) const
+    {
+        pair<iterator, iterator> p =
+                const_cast<robin_hashtable*>(this)->equal_range(__k);
+        return pair<const_iterator, const_iterator>(p.first, p.second);
+    }
+
+    void erase(const const_iterator& __it)
+    { _erase_slot(__it.m_ctrl - m_dist); }
+
+    /**
+     * @brief   Erase the values in [__first, __last). The values
+     *          after an erased one only move back within their run,
+     *          so the next value of the range is always the first
+     *          full slot from the erased slot on
+     */
+    void erase(const_iterator __first, const_iterator __last)
+    {
+        size_type n = 0;
+        for(const_iterator it = __first; it != __last; ++it)
+            ++n;
+        size_type i = __first.m_ctrl - m_dist;
+        for(; n > 0; --n) {
+            _erase_slot(i);
+            while(m_dist[i] == __flat_empty)
+                ++i;
+        }
+    }
+
+    size_type erase(const key_type& __k)
+    {
+        size_type i = _find(__k, _hash(__k));
+        if(i == _slot_count())
+            return 0;
+        _erase_slot(i);
+        return 1;
+    }
+
+    /**
+     * @brief   Erase all elements, keeping the slots
+     */
+    void clear()
+    {
+        _destroy_values();
+        m_size = 0;
+    }
+
+    /**
+     * @brief   Grow the slots to hold __hint_n elements
+     */
+    void resize(size_type __hint_n)
+    {
+        if(__hint_n > _growth_limit(m_capacity))
+            _rehash(_capacity_for(__hint_n));
+    }
+
+    /**
+     * @brief   Return the number of home slots
+     */
+    size_type bucket_count() const { return m_capacity; }
+
+    size_type max_bucket_count() const
+    { return (size_type(-1) / 2 + 1) / sizeof(_Value); }
+
+    friend bool operator==(const robin_hashtable& __x,
+                           const robin_hashtable& __y)
+    {
+        if(__x.size() != __y.size())
+            return false;
+        for(const_iterator it = __x.begin(); it != __x.end(); ++it) {
+            const_iterator j = __y.find(__x.m_getKey(*it));
+            if(j == __y.end() || !(*j == *it))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const robin_hashtable& __x,
+                           const robin_hashtable& __y)
+    { return !(__x == __y); }
+};
+
+} // sstl
+
+
+#endif // SSTL_ROBIN_HASHTABLE_H
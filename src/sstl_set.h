@@ -4,6 +4,7 @@
 #include "sstl_tree.h"
 #include "sstl_alloc.h"
 #include "sstl_functional.h"
+#include "sstl_algo.h"
 
 
 namespace sstl {
@@ -47,6 +48,19 @@ public:
         const _Compare& __comp): m_t(__comp)
     { m_t.insert_unique(__first, __last); }
 
+    /**
+     * @brief   Construct the set in linear time from a range
+     *          which is sorted and free of duplicates
+     */
+    template <class ForwardIter>
+    set(from_sorted_t, ForwardIter __first, ForwardIter __last)
+     : m_t(_Compare()) { m_t.assign_sorted(__first, __last); }
+
+    template <class ForwardIter>
+    set(from_sorted_t, ForwardIter __first, ForwardIter __last,
+        const _Compare& __comp): m_t(__comp)
+    { m_t.assign_sorted(__first, __last); }
+
     set(const set<_Key, _Compare, _Alloc>& __x)
      : m_t(__x.m_t) {}
 
@@ -110,6 +124,24 @@ public:
     void swap(set<_Key, _Compare, _Alloc>& __x)
     { m_t.swap(__x.m_t); }
 
+    /**
+     * @brief   Move the elements not less than __k to __right in
+     *          O(log n) time, replacing the contents of __right
+     * @param   __k: key value to split at
+     * @param   __right: container to receive the larger elements
+     */
+    void split(const key_type& __k, set<_Key, _Compare, _Alloc>& __right)
+    { m_t.split(__k, __right.m_t); }
+
+    /**
+     * @brief   Move all elements of __right to the end of the
+     *          container in O(log n) time, every key of __right
+     *          must be greater than the keys in the container
+     * @param   __right: container whose elements are moved
+     */
+    void join(set<_Key, _Compare, _Alloc>& __right)
+    { m_t.join(__right.m_t); }
+
     /**
      * @brief   Insert element into the container
      * @param   val: element value to insert
@@ -117,6 +149,16 @@ public:
     pair<iterator, bool> insert(const value_type& __val)
     { return m_t.insert_unique(__val); }
 
+    /**
+     * @param   __pos: iterator to the position before which
+     *          the element is expected to be inserted
+     */
+    iterator insert(iterator __pos, const value_type& __val)
+    {
+        typedef typename _Rep_type::iterator _Rep_iterator;
+        return m_t.insert_unique((_Rep_iterator&)__pos, __val);
+    }
+
     /**
      * @brief   Insert element(s) into the container
      * @param   first, last: range of elements to insert
@@ -176,6 +218,16 @@ public:
     iterator lower_bound(const key_type& __x) const
     { return m_t.lower_bound(__x); }
 
+    /**
+     * @brief   Return an iterator pointing to the first element
+     *          that is not less than key, searching from a hint
+     *          instead of from the root
+     * @param   hint: element at or before the result
+     * @param   x: key value to compare the element
+     */
+    iterator lower_bound(iterator __hint, const key_type& __x) const
+    { return m_t.lower_bound(__hint, __x); }
+
     /**
      * @brief   Return an iterator pointing to the first element
      *          that is not bigger than key
@@ -193,6 +245,26 @@ public:
     equal_range(const key_type& __x) const
     { return m_t.equal_range(__x); }
 
+    /**
+     * @brief   Return an iterator to the element with index __k
+     *          in ascending order, or end() if there is none
+     * @param   k: zero-based index of the element
+     */
+    iterator nth(size_type __k) const { return m_t.nth(__k); }
+
+    /**
+     * @brief   Return the number of elements less than key
+     * @param   x: key value to compare the elements
+     */
+    size_type rank(const key_type& __x) const { return m_t.rank(__x); }
+
+    /**
+     * @brief   Return the number of elements in [first, last)
+     * @param   first, last: range of elements in the container
+     */
+    difference_type distance(iterator __first, iterator __last) const
+    { return m_t.distance(__first, __last); }
+
     friend inline bool operator==(const set<_Key, _Compare, _Alloc>& __x,
                                   const set<_Key, _Compare, _Alloc>& __y)
     { return __x.m_t == __y.m_t; }
@@ -223,6 +295,89 @@ public:
     }
 };
 
+/*
+ * Set operations on two sets. Runs of elements which are not in the
+ * other set are skipped by searching the tree from the current
+ * element, so combining a small set with a large one costs about
+ * O(k log(n / k)) comparisons instead of O(k + n)
+ */
+
+/**
+ * @brief   Return true if every element of __y is in __x
+ */
+template <class _Key, class _Compare, class _Alloc>
+inline bool includes(const set<_Key, _Compare, _Alloc>& __x,
+                     const set<_Key, _Compare, _Alloc>& __y)
+{
+    typedef set<_Key, _Compare, _Alloc> _Set;
+    return sstl::__includes_seek(__x.begin(), __x.end(),
+            __y.begin(), __y.end(), __x.key_comp(),
+            __tree_seek<_Set>(__x));
+}
+
+/**
+ * @brief   Copy the elements of __x, __y or both
+ *          in ascending order to __result
+ */
+template <class _Key, class _Compare, class _Alloc, class _OutputIter>
+inline _OutputIter set_union(const set<_Key, _Compare, _Alloc>& __x,
+                             const set<_Key, _Compare, _Alloc>& __y,
+                             _OutputIter __result)
+{
+    typedef set<_Key, _Compare, _Alloc> _Set;
+    return sstl::__set_union_seek(__x.begin(), __x.end(),
+            __y.begin(), __y.end(), __result, __x.key_comp(),
+            __tree_seek<_Set>(__x), __tree_seek<_Set>(__y));
+}
+
+/**
+ * @brief   Copy the elements found in both __x
+ *          and __y in ascending order to __result
+ */
+template <class _Key, class _Compare, class _Alloc, class _OutputIter>
+inline _OutputIter
+set_intersection(const set<_Key, _Compare, _Alloc>& __x,
+                 const set<_Key, _Compare, _Alloc>& __y,
+                 _OutputIter __result)
+{
+    typedef set<_Key, _Compare, _Alloc> _Set;
+    return sstl::__set_intersection_seek(__x.begin(), __x.end(),
+            __y.begin(), __y.end(), __result, __x.key_comp(),
+            __tree_seek<_Set>(__x), __tree_seek<_Set>(__y));
+}
+
+/**
+ * @brief   Copy the elements of __x which are not
+ *          in __y in ascending order to __result
+ */
+template <class _Key, class _Compare, class _Alloc, class _OutputIter>
+inline _OutputIter
+set_difference(const set<_Key, _Compare, _Alloc>& __x,
+               const set<_Key, _Compare, _Alloc>& __y,
+               _OutputIter __result)
+{
+    typedef set<_Key, _Compare, _Alloc> _Set;
+    return sstl::__set_difference_seek(__x.begin(), __x.end(),
+            __y.begin(), __y.end(), __result, __x.key_comp(),
+            __tree_seek<_Set>(__x), __tree_seek<_Set>(__y));
+}
+
+/**
+ * @brief   Copy the elements found in only one of
+ *          __x and __y in ascending order to __result
+ */
+template <class _Key, class _Compare, class _Alloc, class _OutputIter>
+inline _OutputIter
+set_symmetric_difference(const set<_Key, _Compare, _Alloc>& __x,
+                         const set<_Key, _Compare, _Alloc>& __y,
+                         _OutputIter __result)
+{
+    typedef set<_Key, _Compare, _Alloc> _Set;
+    return sstl::__set_symmetric_difference_seek(__x.begin(), __x.end(),
+            __y.begin(), __y.end(), __result, __x.key_comp(),
+            __tree_seek<_Set>(__x), __tree_seek<_Set>(__y));
+}
+
 } // sstl
 
 
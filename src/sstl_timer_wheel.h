@@ -0,0 +1,401 @@
+#ifndef SSTL_TIMER_WHEEL_H
+#define SSTL_TIMER_WHEEL_H
+
+#include <cstddef>
+#include "sstl_config.h"
+#include "sstl_alloc.h"
+#include "sstl_construct.h"
+
+
+namespace sstl {
+
+/**
+ * @brief   Links of a timer node, also used alone as the
+ *          head of the circular list of each slot
+ */
+struct _timer_link {
+    _timer_link* m_prev;
+    _timer_link* m_next;
+};
+
+template <class _Tp>
+struct _timer_node: public _timer_link {
+    unsigned long long m_expiry;
+    _Tp m_data;
+};
+
+/**
+ * @brief   Hierarchical timing wheel: timers carrying a _Tp which
+ *          expire at a tick, fired in batches as time advances.
+ *
+ *          Level 0 has one slot for each of the next 256 ticks, and
+ *          each of the four levels above has 64 slots covering 64
+ *          times the span of the level below. A timer goes into the
+ *          list of the slot of the lowest level whose span reaches its
+ *          expiry, and the slots of a level are moved down a level
+ *          when time gets to them. Scheduling and cancelling take
+ *          constant time, and a timer is moved at most four times
+ *          before it fires, which is cheaper than a heap when most
+ *          timers are cancelled or re-armed before they expire.
+ *          Timers more than 2^32 ticks ahead wait in the top level
+ *          and are placed again when their slot comes.
+ *
+ *          A handle stays valid until its timer is cancelled or fired
+ */
+template <class _Tp, class _Alloc = __SSTL_DEFAULT_ALLOC>
+class timer_wheel {
+public:
+    typedef _Tp                 value_type;
+    typedef _Tp&                reference;
+    typedef const _Tp&          const_reference;
+    typedef size_t              size_type;
+    typedef unsigned long long  tick_type;
+    typedef _timer_node<_Tp>*   handle_type;
+
+private:
+    typedef _timer_node<_Tp> _Node;
+    typedef __SSTL_ALLOC(_Node, _Alloc) node_allocator;
+
+    enum {
+        __root_bits = 8,
+        __level_bits = 6,
+        __levels = 5,               // including level 0
+        __root_slots = 1 << __root_bits,
+        __level_slots = 1 << __level_bits,
+        __slots = __root_slots + (__levels - 1) * __level_slots
+    };
+
+    static const tick_type __root_mask = __root_slots - 1;
+    static const tick_type __level_mask = __level_slots - 1;
+    static const tick_type __max_delta =
+        tick_type(1) << (__root_bits + (__levels - 1) * __level_bits);
+
+    _timer_link m_slots[__slots];   // level 0 first, then levels 1 to 4
+    unsigned long long m_occupied[__root_slots / 64]; // non-empty level 0 slots
+    tick_type m_now;
+    size_type m_size;
+    _Node* m_free_nodes;            // nodes kept for reuse, linked by m_next
+
+    static unsigned int _shift(int __level)
+    { return __root_bits + (__level - 1) * __level_bits; }
+
+    static void _link(_timer_link* __head, _timer_link* __p)
+    {
+        __p->m_prev = __head->m_prev;
+        __p->m_next = __head;
+        __head->m_prev->m_next = __p;
+        __head->m_prev = __p;
+    }
+
+    static void _unlink(_timer_link* __p)
+    {
+        __p->m_prev->m_next = __p->m_next;
+        __p->m_next->m_prev = __p->m_prev;
+    }
+
+    static bool _empty(const _timer_link* __head)
+    { return __head->m_next == __head; }
+
+    /**
+     * @brief   Move all nodes of list __from to the empty list __to
+     */
+    static void _splice(_timer_link* __from, _timer_link* __to)
+    {
+        if(_empty(__from)) {
+            __to->m_prev = __to->m_next = __to;
+            return;
+        }
+        __to->m_next = __from->m_next;
+        __to->m_prev = __from->m_prev;
+        __to->m_next->m_prev = __to;
+        __to->m_prev->m_next = __to;
+        __from->m_prev = __from->m_next = __from;
+    }
+
+    _Node* _get_node()
+    {
+        _Node* p = m_free_nodes;
+        if(p == nullptr)
+            return node_allocator::allocate(1);
+        m_free_nodes = static_cast<_Node*>(p->m_next);
+        return p;
+    }
+
+    void _put_node(_Node* __p)
+    {
+        __p->m_next = m_free_nodes;
+        m_free_nodes = __p;
+    }
+
+    /**
+     * @brief   Put __p in the slot for its expiry, which
+     *          must not be before m_now
+     */
+    void _place(_Node* __p)
+    {
+        const tick_type expiry = __p->m_expiry;
+        const tick_type delta = expiry - m_now;
+        if(delta < __root_slots) {
+            const size_type i = size_type(expiry & __root_mask);
+            m_occupied[i / 64] |= 1ull << (i % 64);
+            _link(&m_slots[i], __p);
+            return;
+        }
+        // a timer beyond the top level goes to its last slot
+        const tick_type t = delta < __max_delta ? expiry : m_now + __max_delta - 1;
+        int level = 1;
+        while(delta >= tick_type(1) << (_shift(level) + __level_bits)
+              && level < __levels - 1)
+            ++level;
+        const size_type i = size_type((t >> _shift(level)) & __level_mask);
+        _link(&m_slots[__root_slots + (level - 1) * __level_slots + i], __p);
+    }
+
+    /**
+     * @brief   Move the timers of the slot of __level for m_now
+     *          to the levels below
+     */
+    void _cascade(int __level)
+    {
+        const size_type i = size_type((m_now >> _shift(__level)) & __level_mask);
+        _timer_link batch;
+        _splice(&m_slots[__root_slots + (__level - 1) * __level_slots + i], &batch);
+        while(!_empty(&batch)) {
+            _Node* p = static_cast<_Node*>(batch.m_next);
+            _unlink(p);
+            _place(p);
+        }
+    }
+
+    /**
+     * @brief   Return the first tick after m_now and not after __now whose
+     *          level 0 slot has timers or at which the levels above are
+     *          cascaded, or __now if there is none
+     */
+    tick_type _next_tick(tick_type __now) const
+    {
+        tick_type t = m_now + 1;
+        size_type i = size_type(t & __root_mask);
+        if(i != 0) {
+            // look for a timer in the slots up to the end of the round
+            unsigned long long w = m_occupied[i / 64] & (~0ull << (i % 64));
+            size_type j = i / 64;
+            while(w == 0 && ++j < __root_slots / 64)
+                w = m_occupied[j];
+            if(w != 0)
+                t = (t & ~__root_mask) + j * 64 + size_type(__builtin_ctzll(w));
+            else
+                t = (t | __root_mask) + 1;
+        }
+        return t < __now ? t : __now;
+    }
+
+    /**
+     * @brief   Fire the timers of level 0 slot __i, taking them out of
+     *          the wheel first so that __f may schedule and cancel
+     */
+    template <class Function>
+    size_type _fire(size_type __i, Function& __f)
+    {
+        m_occupied[__i / 64] &= ~(1ull << (__i % 64));
+        _timer_link batch;
+        _splice(&m_slots[__i], &batch);
+        size_type n = 0;
+        __SSTL_TRY {
+            while(!_empty(&batch)) {
+                _Node* p = static_cast<_Node*>(batch.m_next);
+                _unlink(p);
+                --m_size;
+                ++n;
+                __SSTL_TRY {
+                    __f(p->m_data);
+                }
+#ifdef __SSTL_USE_EXCEPTIONS
+                catch(...) {
+                    sstl::destroy(&p->m_data);
+                    _put_node(p);
+                    throw;
+                }
+#endif
+                sstl::destroy(&p->m_data);
+                _put_node(p);
+            }
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            // the rest of the batch fires at the next tick
+            while(!_empty(&batch)) {
+                _Node* p = static_cast<_Node*>(batch.m_next);
+                _unlink(p);
+                const size_type j = size_type((m_now + 1) & __root_mask);
+                m_occupied[j / 64] |= 1ull << (j % 64);
+                _link(&m_slots[j], p);
+            }
+            throw;
+        }
+#endif
+        return n;
+    }
+
+public:
+    /**
+     * @brief   Make an empty wheel whose current tick is __now
+     */
+    explicit timer_wheel(tick_type __now = 0)
+     : m_now(__now), m_size(0), m_free_nodes(nullptr)
+    {
+        for(int i = 0; i < __slots; ++i)
+            m_slots[i].m_prev = m_slots[i].m_next = &m_slots[i];
+        for(int i = 0; i < __root_slots / 64; ++i)
+            m_occupied[i] = 0;
+    }
+
+    // handles point into the wheel
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    ~timer_wheel()
+    {
+        clear();
+        while(m_free_nodes != nullptr) {
+            _Node* next = static_cast<_Node*>(m_free_nodes->m_next);
+            node_allocator::deallocate(m_free_nodes);
+            m_free_nodes = next;
+        }
+    }
+
+    /**
+     * @brief   Return the number of pending timers
+     */
+    size_type size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief   Return the current tick, the last one advanced to
+     */
+    tick_type now() const { return m_now; }
+
+    /**
+     * @brief   Return the tick at which the timer of __h expires
+     */
+    tick_type expiry(handle_type __h) const { return __h->m_expiry; }
+
+    /**
+     * @brief   Return the value of the timer of __h
+     */
+    reference value(handle_type __h) { return __h->m_data; }
+
+    const_reference value(handle_type __h) const { return __h->m_data; }
+
+    /**
+     * @brief   Schedule a timer carrying __val to fire at tick __expiry,
+     *          or at the next tick if __expiry is not after now()
+     * @return  handle to cancel or reschedule the timer
+     */
+    handle_type schedule(tick_type __expiry, const value_type& __val)
+    {
+        _Node* p = _get_node();
+        __SSTL_TRY {
+            sstl::construct(&p->m_data, __val);
+        }
+#ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            _put_node(p);
+            throw;
+        }
+#endif
+        p->m_expiry = __expiry > m_now ? __expiry : m_now + 1;
+        _place(p);
+        ++m_size;
+        return p;
+    }
+
+    /**
+     * @brief   Schedule a timer __delay ticks after now()
+     */
+    handle_type schedule_after(tick_type __delay, const value_type& __val)
+    { return schedule(m_now + __delay, __val); }
+
+    /**
+     * @brief   Move the pending timer of __h to tick __expiry,
+     *          keeping its value and handle
+     */
+    void reschedule(handle_type __h, tick_type __expiry)
+    {
+        _unlink(__h);
+        __h->m_expiry = __expiry > m_now ? __expiry : m_now + 1;
+        _place(__h);
+    }
+
+    /**
+     * @brief   Remove the pending timer of __h without firing it
+     */
+    void cancel(handle_type __h)
+    {
+        // the occupied bit of a slot emptied here is cleared when
+        // the slot is reached
+        _unlink(__h);
+        sstl::destroy(&__h->m_data);
+        _put_node(__h);
+        --m_size;
+    }
+
+    /**
+     * @brief   Move the current tick to __now, calling __f with the
+     *          value of each timer expiring up to __now, in order of
+     *          expiry. __f may schedule and cancel timers, timers it
+     *          schedules at or before __now fire in this call. The
+     *          handle of a timer is no longer valid when __f is called
+     * @return  the number of timers fired
+     */
+    template <class Function>
+    size_type advance(tick_type __now, Function __f)
+    {
+        size_type n = 0;
+        while(m_now < __now) {
+            if(m_size == 0) {
+                m_now = __now;
+                break;
+            }
+            m_now = _next_tick(__now);
+            const size_type i = size_type(m_now & __root_mask);
+            if(i == 0) {
+                // cascade from the highest level whose slot changes
+                int level = 1;
+                while(level < __levels - 1
+                      && ((m_now >> _shift(level)) & __level_mask) == 0)
+                    ++level;
+                for(; level >= 1; --level)
+                    _cascade(level);
+            }
+            if(m_occupied[i / 64] & (1ull << (i % 64)))
+                n += _fire(i, __f);
+        }
+        return n;
+    }
+
+    /**
+     * @brief   Remove all pending timers without firing them
+     */
+    void clear()
+    {
+        for(int i = 0; i < __slots; ++i) {
+            _timer_link* head = &m_slots[i];
+            while(!_empty(head)) {
+                _Node* p = static_cast<_Node*>(head->m_next);
+                _unlink(p);
+                sstl::destroy(&p->m_data);
+                _put_node(p);
+            }
+        }
+        for(int i = 0; i < __root_slots / 64; ++i)
+            m_occupied[i] = 0;
+        m_size = 0;
+    }
+};
+
+} // sstl
+
+
+#endif // SSTL_TIMER_WHEEL_H
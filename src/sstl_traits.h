@@ -20,7 +20,7 @@ template <class T>
 struct __type_traits {
     typedef __false_type    has_trivial_default_constructor;
     typedef __false_type    has_trivial_copy_constructor;
-    typedef __false_type    has_trivial_assginment_operator;
+    typedef __false_type    has_trivial_assignment_operator;
     typedef __false_type    has_trivial_destructor;
     typedef __false_type    is_POD_type;
 };
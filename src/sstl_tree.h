@@ -1,9 +1,12 @@
 #ifndef SSTL_TREE_H
 #define SSTL_TREE_H
 
+#include <stdint.h>
+#include <iterator>
 #include "sstl_config.h"
 #include "sstl_iterator.h"
 #include "sstl_alloc.h"
+#include "sstl_algobase.h"
 #include "sstl_construct.h"
 #include "sstl_pair.h"
 
@@ -12,19 +15,61 @@ namespace sstl {
 
 typedef bool __rb_tree_color_type;
 
+// red must be 0, a compact header then keeps the root
+// pointer in its parent field unchanged
 const __rb_tree_color_type __rb_tree_red = false;
 const __rb_tree_color_type __rb_tree_black = true;
 
+/**
+ * @brief   Tag to construct a tree from a range which is already
+ *          sorted by key (and free of duplicates for unique trees)
+ */
+struct from_sorted_t {};
+
+const from_sorted_t from_sorted = from_sorted_t();
+
 class __rb_tree_node_base {
 private:
     typedef __rb_tree_color_type _Color_type;
     typedef __rb_tree_node_base* _Base_ptr;
 
 public:
+#ifdef __SSTL_RB_TREE_COMPACT_NODES
+    _Base_ptr m_parent; // the low bit holds the color, use parent()
+#else
     _Color_type m_color;
     _Base_ptr m_parent;
+#endif
     _Base_ptr m_left;
     _Base_ptr m_right;
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+    size_t m_size; // number of nodes in the subtree
+#endif
+
+#ifdef __SSTL_RB_TREE_COMPACT_NODES
+    _Base_ptr parent() const
+    { return (_Base_ptr)((uintptr_t)m_parent & ~(uintptr_t)1); }
+
+    void set_parent(_Base_ptr __p)
+    { m_parent = (_Base_ptr)((uintptr_t)__p | ((uintptr_t)m_parent & 1)); }
+
+    _Color_type color() const
+    { return (_Color_type)((uintptr_t)m_parent & 1); }
+
+    void set_color(_Color_type __c)
+    {
+        m_parent = (_Base_ptr)(((uintptr_t)m_parent & ~(uintptr_t)1) |
+                               (uintptr_t)__c);
+    }
+#else
+    _Base_ptr parent() const { return m_parent; }
+
+    void set_parent(_Base_ptr __p) { m_parent = __p; }
+
+    _Color_type color() const { return m_color; }
+
+    void set_color(_Color_type __c) { m_color = __c; }
+#endif
 
     /**
      * @brief   Return the pointer to the node
@@ -58,10 +103,11 @@ public:
 
 class __rb_tree_iterator_base
 {
-protected:
+public:
     typedef __rb_tree_node_base* _Base_ptr;
     _Base_ptr m_node;
 
+protected:
     /**
      * @brief   Move m_node to the node whose value
      *          is larger than current value
@@ -73,10 +119,10 @@ protected:
             while(m_node->m_left != nullptr)
                 m_node = m_node->m_left;
         } else {
-            _Base_ptr p = m_node->m_parent;
+            _Base_ptr p = m_node->parent();
             while(m_node == p->m_right) {
                 m_node = p;
-                p = p->m_parent;
+                p = p->parent();
             }
             if(m_node->m_right != p)
                 m_node = p;
@@ -89,8 +135,8 @@ protected:
      */
     void decrement()
     {
-        if(m_node->m_color == __rb_tree_red &&
-           m_node->m_parent->m_parent == m_node)
+        if(m_node->color() == __rb_tree_red &&
+           m_node->parent()->parent() == m_node)
             m_node = m_node->m_right;
         else if(m_node->m_left != nullptr) {
             _Base_ptr r = m_node->m_left;
@@ -98,10 +144,10 @@ protected:
                 r = r->m_right;
             m_node = r;
         } else {
-            _Base_ptr p = m_node->m_parent;
+            _Base_ptr p = m_node->parent();
             while(m_node == p->m_left) {
                 m_node = p;
-                p = m_node->m_parent;
+                p = m_node->parent();
             }
             m_node = p;
         }
@@ -165,15 +211,34 @@ public:
         return tmp;
     }
 
-    friend inline bool operator==(const iterator& __x,
-                                  const iterator& __y)
+    friend inline bool operator==(const _Self& __x,
+                                  const _Self& __y)
     { return __x.m_node == __y.m_node; }
 
-    friend inline bool operator!=(const iterator& __x,
-                                  const iterator& __y)
+    friend inline bool operator!=(const _Self& __x,
+                                  const _Self& __y)
     { return __x.m_node != __y.m_node; }
 };
 
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+/**
+ * @brief   Return the number of nodes in the subtree of __x
+ */
+inline size_t
+__rb_tree_subtree_size(const __rb_tree_node_base* __x)
+{ return __x == nullptr ? 0 : __x->m_size; }
+
+/**
+ * @brief   Recompute the subtree size of __x from its children
+ */
+inline void
+__rb_tree_update_size(__rb_tree_node_base* __x)
+{
+    __x->m_size = __rb_tree_subtree_size(__x->m_left) +
+                  __rb_tree_subtree_size(__x->m_right) + 1;
+}
+#endif
+
 /**
  * @brief   Make a rotation of tree in anti-clockwise direction
  * @param   __x: root node of subtree which will be rotated
@@ -187,20 +252,24 @@ __rb_tree_rotate_left(__rb_tree_node_base* __x,
     // connect x and left child of y
     __x->m_right = y->m_left;
     if(y->m_left != nullptr)
-        y->m_left->m_parent = __x;
+        y->m_left->set_parent(__x);
 
     // connect y and parent of x
     if(__x == __root)
         __root = y;
-    else if(__x == __x->m_parent->m_left)
-        __x->m_parent->m_left = y;
+    else if(__x == __x->parent()->m_left)
+        __x->parent()->m_left = y;
     else
-        __x->m_parent->m_right = y;
-    y->m_parent = __x->m_parent;
+        __x->parent()->m_right = y;
+    y->set_parent(__x->parent());
 
     // connect x and y
     y->m_left = __x;
-    __x->m_parent = y;
+    __x->set_parent(y);
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+    y->m_size = __x->m_size;
+    __rb_tree_update_size(__x);
+#endif
 }
 
 /**
@@ -216,20 +285,24 @@ __rb_tree_rotate_right(__rb_tree_node_base* __x,
     // connect x and right child of y
     __x->m_left = y->m_right;
     if(y->m_right != nullptr)
-        y->m_right->m_parent = __x;
+        y->m_right->set_parent(__x);
 
     // connect y and parent of x
     if(__x == __root)
         __root = y;
-    else if(__x == __x->m_parent->m_right)
-        __x->m_parent->m_right = y;
+    else if(__x == __x->parent()->m_right)
+        __x->parent()->m_right = y;
     else
-        __x->m_parent->m_left = y;
-    y->m_parent = __x->m_parent;
+        __x->parent()->m_left = y;
+    y->set_parent(__x->parent());
 
     // connect x and y
     y->m_right = __x;
-    __x->m_parent = y;
+    __x->set_parent(y);
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+    y->m_size = __x->m_size;
+    __rb_tree_update_size(__x);
+#endif
 }
 
 /**
@@ -243,48 +316,342 @@ __rb_tree_rotate_right(__rb_tree_node_base* __x,
  *             same number of black nodes
  * @param   __x: new node to insert
  * @param   __root: root node of rb-tree
+ * @return  Whether the root was red and turned black, which
+ *          adds one to the black height of the tree
  */
-inline void
+inline bool
 __rb_tree_rebalance(__rb_tree_node_base* __x,
                     __rb_tree_node_base*& __root)
 {
-    __x->m_color = __rb_tree_red; // the color of new node must be red
-    while(__x != __root && __x->m_parent->m_color == __rb_tree_red) {
-        if(__x->m_parent == __x->m_parent->m_parent->m_left) { // parent is the left child node of grandparent
-            __rb_tree_node_base* y = __x->m_parent->m_parent->m_right; // uncle
-            if(y && y->m_color == __rb_tree_red) { // the color of uncle is red
-                __x->m_parent->m_color = __rb_tree_black;
-                y->m_color = __rb_tree_black;
-                __x->m_parent->m_parent->m_color = __rb_tree_red;
-                __x = __x->m_parent->m_parent;
+    __x->set_color(__rb_tree_red); // the color of new node must be red
+    while(__x != __root && __x->parent()->color() == __rb_tree_red) {
+        if(__x->parent() == __x->parent()->parent()->m_left) { // parent is the left child node of grandparent
+            __rb_tree_node_base* y = __x->parent()->parent()->m_right; // uncle
+            if(y && y->color() == __rb_tree_red) { // the color of uncle is red
+                __x->parent()->set_color(__rb_tree_black);
+                y->set_color(__rb_tree_black);
+                __x->parent()->parent()->set_color(__rb_tree_red);
+                __x = __x->parent()->parent();
             } else { // the color of uncle is black
-                if(__x == __x->m_parent->m_right) {
-                    __x = __x->m_parent;
+                if(__x == __x->parent()->m_right) {
+                    __x = __x->parent();
                     __rb_tree_rotate_left(__x, __root);
                 }
-                __x->m_parent->m_color = __rb_tree_black;
-                __x->m_parent->m_parent->m_color = __rb_tree_red;
-                __rb_tree_rotate_right(__x->m_parent->m_parent, __root);
+                __x->parent()->set_color(__rb_tree_black);
+                __x->parent()->parent()->set_color(__rb_tree_red);
+                __rb_tree_rotate_right(__x->parent()->parent(), __root);
             }
         } else { // parent is the right child node of grandparent
-            __rb_tree_node_base* y = __x->m_parent->m_parent->m_left; // uncle
-            if(y && y->m_color == __rb_tree_red) {
-                __x->m_parent->m_color = __rb_tree_black;
-                y->m_color = __rb_tree_black;
-                __x->m_parent->m_parent->m_color = __rb_tree_red;
-                __x = __x->m_parent->m_parent;
+            __rb_tree_node_base* y = __x->parent()->parent()->m_left; // uncle
+            if(y && y->color() == __rb_tree_red) {
+                __x->parent()->set_color(__rb_tree_black);
+                y->set_color(__rb_tree_black);
+                __x->parent()->parent()->set_color(__rb_tree_red);
+                __x = __x->parent()->parent();
             } else { //
-                if(__x == __x->m_parent->m_left) {
-                    __x = __x->m_parent;
+                if(__x == __x->parent()->m_left) {
+                    __x = __x->parent();
                     __rb_tree_rotate_right(__x, __root);
                 }
-                __x->m_parent->m_color = __rb_tree_black;
-                __x->m_parent->m_parent->m_color = __rb_tree_red;
-                __rb_tree_rotate_left(__x->m_parent->m_parent, __root);
+                __x->parent()->set_color(__rb_tree_black);
+                __x->parent()->parent()->set_color(__rb_tree_red);
+                __rb_tree_rotate_left(__x->parent()->parent(), __root);
             }
         }
     }
-    __root->m_color = __rb_tree_black;
+    bool grown = __root->color() == __rb_tree_red;
+    __root->set_color(__rb_tree_black);
+    return grown;
+}
+
+/**
+ * @brief   Unlink __z from the tree and rebalance the tree to keep
+ *          the properties listed in __rb_tree_rebalance
+ * @param   __z: node to remove
+ * @param   __root: root node of rb-tree
+ * @param   __leftmost: smallest node of rb-tree
+ * @param   __rightmost: largest node of rb-tree
+ * @return  The node which was unlinked and can be destroyed
+ */
+inline __rb_tree_node_base*
+__rb_tree_rebalance_for_erase(__rb_tree_node_base* __z,
+                              __rb_tree_node_base*& __root,
+                              __rb_tree_node_base*& __leftmost,
+                              __rb_tree_node_base*& __rightmost)
+{
+    __rb_tree_node_base* y = __z;
+    __rb_tree_node_base* x = nullptr;
+    __rb_tree_node_base* x_parent = nullptr;
+
+    if(y->m_left == nullptr) // z has at most one non-null child
+        x = y->m_right;
+    else if(y->m_right == nullptr)
+        x = y->m_left;
+    else { // z has two children, y is the successor of z
+        y = __rb_tree_node_base::minimum(y->m_right);
+        x = y->m_right;
+    }
+
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+    // every ancestor of the node leaving its place loses one node
+    for(__rb_tree_node_base* p = y->parent(); p != __root->parent(); p = p->parent())
+        --p->m_size;
+#endif
+
+    if(y != __z) { // move y to the place of z
+        __z->m_left->set_parent(y);
+        y->m_left = __z->m_left;
+        if(y != __z->m_right) {
+            x_parent = y->parent();
+            if(x != nullptr)
+                x->set_parent(y->parent());
+            y->parent()->m_left = x;
+            y->m_right = __z->m_right;
+            __z->m_right->set_parent(y);
+        } else
+            x_parent = y;
+
+        if(__root == __z)
+            __root = y;
+        else if(__z->parent()->m_left == __z)
+            __z->parent()->m_left = y;
+        else
+            __z->parent()->m_right = y;
+        y->set_parent(__z->parent());
+
+        __rb_tree_color_type c = y->color();
+        y->set_color(__z->color());
+        __z->set_color(c);
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        y->m_size = __z->m_size;
+#endif
+        y = __z; // y is the node to destroy
+    } else { // replace z with its only child
+        x_parent = y->parent();
+        if(x != nullptr)
+            x->set_parent(y->parent());
+
+        if(__root == __z)
+            __root = x;
+        else if(__z->parent()->m_left == __z)
+            __z->parent()->m_left = x;
+        else
+            __z->parent()->m_right = x;
+
+        if(__leftmost == __z)
+            __leftmost = __z->m_right == nullptr ?
+                         __z->parent() : __rb_tree_node_base::minimum(x);
+        if(__rightmost == __z)
+            __rightmost = __z->m_left == nullptr ?
+                          __z->parent() : __rb_tree_node_base::maximum(x);
+    }
+
+    if(y->color() != __rb_tree_red) { // a black node is missing on the path of x
+        while(x != __root && (x == nullptr || x->color() == __rb_tree_black)) {
+            if(x == x_parent->m_left) {
+                __rb_tree_node_base* w = x_parent->m_right; // sibling
+                if(w->color() == __rb_tree_red) {
+                    w->set_color(__rb_tree_black);
+                    x_parent->set_color(__rb_tree_red);
+                    __rb_tree_rotate_left(x_parent, __root);
+                    w = x_parent->m_right;
+                }
+                if((w->m_left == nullptr || w->m_left->color() == __rb_tree_black) &&
+                   (w->m_right == nullptr || w->m_right->color() == __rb_tree_black)) {
+                    w->set_color(__rb_tree_red);
+                    x = x_parent;
+                    x_parent = x_parent->parent();
+                } else {
+                    if(w->m_right == nullptr || w->m_right->color() == __rb_tree_black) {
+                        if(w->m_left != nullptr)
+                            w->m_left->set_color(__rb_tree_black);
+                        w->set_color(__rb_tree_red);
+                        __rb_tree_rotate_right(w, __root);
+                        w = x_parent->m_right;
+                    }
+                    w->set_color(x_parent->color());
+                    x_parent->set_color(__rb_tree_black);
+                    if(w->m_right != nullptr)
+                        w->m_right->set_color(__rb_tree_black);
+                    __rb_tree_rotate_left(x_parent, __root);
+                    break;
+                }
+            } else { // same as above, with left and right exchanged
+                __rb_tree_node_base* w = x_parent->m_left;
+                if(w->color() == __rb_tree_red) {
+                    w->set_color(__rb_tree_black);
+                    x_parent->set_color(__rb_tree_red);
+                    __rb_tree_rotate_right(x_parent, __root);
+                    w = x_parent->m_left;
+                }
+                if((w->m_right == nullptr || w->m_right->color() == __rb_tree_black) &&
+                   (w->m_left == nullptr || w->m_left->color() == __rb_tree_black)) {
+                    w->set_color(__rb_tree_red);
+                    x = x_parent;
+                    x_parent = x_parent->parent();
+                } else {
+                    if(w->m_left == nullptr || w->m_left->color() == __rb_tree_black) {
+                        if(w->m_right != nullptr)
+                            w->m_right->set_color(__rb_tree_black);
+                        w->set_color(__rb_tree_red);
+                        __rb_tree_rotate_left(w, __root);
+                        w = x_parent->m_left;
+                    }
+                    w->set_color(x_parent->color());
+                    x_parent->set_color(__rb_tree_black);
+                    if(w->m_left != nullptr)
+                        w->m_left->set_color(__rb_tree_black);
+                    __rb_tree_rotate_right(x_parent, __root);
+                    break;
+                }
+            }
+        }
+        if(x != nullptr)
+            x->set_color(__rb_tree_black);
+    }
+    return y;
+}
+
+/**
+ * @brief   Return the number of black nodes on a path from
+ *          __x down to a leaf, counting __x itself
+ */
+inline int
+__rb_tree_black_height(const __rb_tree_node_base* __x)
+{
+    int h = 0;
+    for(; __x != nullptr; __x = __x->m_left)
+        h += __x->color() == __rb_tree_black;
+    return h;
+}
+
+/**
+ * @brief   Cut the subtree __x off its parent and make it a tree
+ *          with a black root
+ * @param   __bh: black height of __x, updated if the root turns black
+ */
+inline __rb_tree_node_base*
+__rb_tree_detach(__rb_tree_node_base* __x, int& __bh)
+{
+    if(__x != nullptr) {
+        __x->set_parent(nullptr);
+        if(__x->color() == __rb_tree_red) {
+            __x->set_color(__rb_tree_black);
+            ++__bh;
+        }
+    }
+    return __x;
+}
+
+/**
+ * @brief   Join two trees with black roots and the node __k, all
+ *          keys of __l being before __k and all keys of __r after
+ *          it. __k is hung on the spine of the higher tree where the
+ *          black heights match, then rebalanced as a new node, which
+ *          takes O(|__lbh - __rbh| + 1) time
+ * @param   __l, __lbh: root and black height of the left tree
+ * @param   __k: node to put between the two trees
+ * @param   __r, __rbh: root and black height of the right tree
+ * @param   __bh: set to the black height of the joined tree
+ * @return  The root of the joined tree, whose parent is null
+ */
+inline __rb_tree_node_base*
+__rb_tree_join(__rb_tree_node_base* __l, int __lbh,
+               __rb_tree_node_base* __k,
+               __rb_tree_node_base* __r, int __rbh, int& __bh)
+{
+    if(__lbh == __rbh) {
+        __k->m_left = __l;
+        __k->m_right = __r;
+        __k->set_parent(nullptr);
+        __k->set_color(__rb_tree_black);
+        if(__l != nullptr) __l->set_parent(__k);
+        if(__r != nullptr) __r->set_parent(__k);
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        __rb_tree_update_size(__k);
+#endif
+        __bh = __lbh + 1;
+        return __k;
+    }
+
+    const bool right_spine = __lbh > __rbh;
+    __rb_tree_node_base* root = right_spine ? __l : __r;
+    __rb_tree_node_base* other = right_spine ? __r : __l;
+    const int other_bh = right_spine ? __rbh : __lbh;
+
+    // find the black node on the spine as high as the other tree
+    __rb_tree_node_base* c = root;
+    __rb_tree_node_base* p = nullptr;
+    for(int h = right_spine ? __lbh : __rbh;
+        !(h == other_bh && (c == nullptr || c->color() == __rb_tree_black)); ) {
+        h -= c->color() == __rb_tree_black;
+        p = c;
+        c = right_spine ? c->m_right : c->m_left;
+    }
+
+    if(right_spine) {
+        __k->m_left = c;
+        __k->m_right = other;
+        p->m_right = __k;
+    } else {
+        __k->m_left = other;
+        __k->m_right = c;
+        p->m_left = __k;
+    }
+    __k->set_parent(p);
+    if(c != nullptr) c->set_parent(__k);
+    if(other != nullptr) other->set_parent(__k);
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+    __rb_tree_update_size(__k);
+    for(; p != nullptr; p = p->parent())
+        p->m_size += __rb_tree_subtree_size(other) + 1;
+#endif
+
+    __bh = (right_spine ? __lbh : __rbh) +
+           (__rb_tree_rebalance(__k, root) ? 1 : 0);
+    return root;
+}
+
+/**
+ * @brief   Split the tree holding __x into the nodes before
+ *          __x and the nodes after __x, leaving __x out of both.
+ *          Going up from __x, each node on the path joins the part
+ *          on its side, which takes O(log n) time in total
+ * @param   __bh: black height of the tree, whose root
+ *          must have a null parent
+ * @param   __x: node to split the tree at
+ * @param   __l, __lbh, __r, __rbh: set to the two parts
+ */
+inline void
+__rb_tree_split(int __bh, __rb_tree_node_base* __x,
+                __rb_tree_node_base*& __l, int& __lbh,
+                __rb_tree_node_base*& __r, int& __rbh)
+{
+    // the path from __x up to root, a rb-tree is at most 2 log(n) high
+    __rb_tree_node_base* path[2 * sizeof(size_t) * 8 + 2];
+    int heights[2 * sizeof(size_t) * 8 + 2];
+    int depth = 0;
+    for(__rb_tree_node_base* p = __x; p != nullptr; p = p->parent())
+        path[depth++] = p;
+    heights[depth - 1] = __bh;
+    for(int i = depth - 2; i >= 0; --i)
+        heights[i] = heights[i + 1] - (path[i + 1]->color() == __rb_tree_black);
+
+    __lbh = __rbh = heights[0] - (__x->color() == __rb_tree_black);
+    __l = __rb_tree_detach(__x->m_left, __lbh);
+    __r = __rb_tree_detach(__x->m_right, __rbh);
+
+    for(int i = 1; i < depth; ++i) {
+        __rb_tree_node_base* t = path[i];
+        int h = heights[i] - (t->color() == __rb_tree_black);
+        if(t->m_left == path[i - 1]) { // t and its right subtree are after __x
+            __rb_tree_node_base* tr = __rb_tree_detach(t->m_right, h);
+            __r = __rb_tree_join(__r, __rbh, t, tr, h, __rbh);
+        } else {
+            __rb_tree_node_base* tl = __rb_tree_detach(t->m_left, h);
+            __l = __rb_tree_join(tl, h, t, __l, __lbh, __lbh);
+        }
+    }
 }
 
 template <class _Tp, class _Alloc>
@@ -303,11 +670,55 @@ protected:
     void _deallocate_node(__rb_tree_node<_Tp>* __p)
     { node_allocator_type::deallocate(__p, 1); }
 
+    /**
+     * @brief   Take a node from the free list of the tree, or
+     *          request a new one if the free list is empty
+     */
+    __rb_tree_node<_Tp>* _get_node()
+    {
+        __rb_tree_node<_Tp>* p = m_free_nodes;
+        if(p == nullptr)
+            return _allocate_node();
+        m_free_nodes = (__rb_tree_node<_Tp>*)p->m_right;
+        --m_free_count;
+        return p;
+    }
+
+    /**
+     * @brief   Keep a node whose value has been destroyed
+     *          in the free list for later reuse
+     */
+    void _put_node(__rb_tree_node<_Tp>* __p)
+    {
+        __p->m_right = m_free_nodes;
+        m_free_nodes = __p;
+        ++m_free_count;
+    }
+
+    /**
+     * @brief   Return all nodes in the free list to the allocator
+     */
+    void _release_free_nodes()
+    {
+        while(m_free_nodes != nullptr) {
+            __rb_tree_node<_Tp>* next =
+                    (__rb_tree_node<_Tp>*)m_free_nodes->m_right;
+            _deallocate_node(m_free_nodes);
+            m_free_nodes = next;
+        }
+        m_free_count = 0;
+    }
+
 public:
-    explicit __rb_tree_base(const allocator_type&) {}
+    explicit __rb_tree_base(const allocator_type&)
+     : m_free_nodes(nullptr), m_free_count(0) {}
+
+    ~__rb_tree_base() { _release_free_nodes(); }
 
 protected:
     __rb_tree_node<_Tp>* m_header;
+    __rb_tree_node<_Tp>* m_free_nodes; // destroyed nodes kept for reuse
+    size_t m_free_count;
 };
 
 template <class _Key,
@@ -342,23 +753,29 @@ public:
 private:
     using _Base::_allocate_node;
     using _Base::_deallocate_node;
+    using _Base::_get_node;
+    using _Base::_put_node;
+    using _Base::_release_free_nodes;
+    using _Base::m_free_count;
 
     /**
-     * @brief   Allocate and construct an object
+     * @brief   Allocate and construct an object, reusing
+     *          a node from the free list when possible
      * @param   __x: element value to create
      */
     _Link_type _create_node(const value_type& __x)
     {
-        _Link_type p = _allocate_node();
+        _Link_type p = _get_node();
         __SSTL_TRY {
-            sstl::construct(p, __x);
+            sstl::construct(&p->m_data, __x);
         }
     #ifdef __SSTL_USE_EXCEPTIONS
         catch(...) {
-            _deallocate_node(p);
+            _put_node(p);
+            throw;
         }
-        return p;
     #endif
+        return p;
     }
 
     /**
@@ -368,20 +785,23 @@ private:
     _Link_type _clone_node(_Link_type __p)
     {
         _Link_type p_clone = _create_node(__p->m_data);
-        p_clone->color = __p->color;
+        p_clone->set_color(__p->color());
         p_clone->m_left = 0;
         p_clone->m_right = 0;
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        p_clone->m_size = __p->m_size;
+#endif
         return p_clone;
     }
 
     /**
-     * @brief   Destroy data and reallocate a node
+     * @brief   Destroy data and keep the node in the free list
      * @param   __p: pointer to node which will be deleted
      */
     void _destroy_node(_Link_type __p)
     {
         sstl::destroy(&__p->m_data);
-        _deallocate_node(__p);
+        _put_node(__p);
     }
 
 protected:
@@ -390,7 +810,9 @@ protected:
     _Compare m_key_compare;
 
     /**
-     * @brief   Return the reference to root node
+     * @brief   Return the reference to root node. The header is
+     *          always red, so its parent field holds a plain pointer
+     *          even with compact nodes
      */
     _Link_type& _root() const
     { return (_Link_type&)(m_header->m_parent); }
@@ -420,10 +842,10 @@ protected:
     { return (_Link_type&)(p->m_right); }
 
     /**
-     * @brief   Return the reference to parent node
+     * @brief   Return the parent node
      */
-    static _Link_type& _parent(_Base_ptr p)
-    { return (_Link_type&)(p->m_parent); }
+    static _Link_type _parent(_Base_ptr p)
+    { return (_Link_type)p->parent(); }
 
     /**
      * @brief   Return the reference to node value
@@ -438,22 +860,22 @@ protected:
     { return _KeyOfValue()(_value(p)); }
 
     /**
-     * @brief   Return the reference to node color
+     * @brief   Return the node color
      */
-    static _Color_type& _color(_Base_ptr p)
-    { return p->m_color; }
+    static _Color_type _color(_Base_ptr p)
+    { return p->color(); }
 
     /**
      * @brief   Return the reference to leftmost node
      */
     static _Link_type minimum(_Base_ptr p)
-    { return __rb_tree_node_base::minimum(p); }
+    { return (_Link_type)__rb_tree_node_base::minimum(p); }
 
     /**
      * @brief   Return the reference to rightmost node
      */
     static _Link_type maximum(_Base_ptr p)
-    { return __rb_tree_node_base::maximum(p); }
+    { return (_Link_type)__rb_tree_node_base::maximum(p); }
 
 public:
     typedef __rb_tree_iterator<_Value, _Value&, _Value*>
@@ -471,9 +893,9 @@ private:
                      _Base_ptr __pare,
                      const value_type& __val)
     {
-        _Link_type cur = __cur;
-        _Link_type pare = __pare;
-        _Link_type tmp = _create_node(__val);;
+        _Link_type cur = (_Link_type)__cur;
+        _Link_type pare = (_Link_type)__pare;
+        _Link_type tmp = _create_node(__val);
 
         /* When we add to the left child node:
          * 1. there's no node in rb-tree
@@ -494,9 +916,14 @@ private:
                 _rightmost() = tmp;
         }
 
-        _parent(tmp) = pare;
+        tmp->set_parent(pare);
         _left(tmp) = nullptr;
         _right(tmp) = nullptr;
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        tmp->m_size = 1;
+        for(_Base_ptr p = pare; p != m_header; p = p->parent())
+            ++p->m_size;
+#endif
 
         __rb_tree_rebalance(tmp, m_header->m_parent);
         ++m_node_count;
@@ -511,11 +938,11 @@ private:
     _Link_type _copy(_Link_type __x, _Link_type __p)
     {
         _Link_type top = _clone_node(__x);
-        top->m_parent = __p;
+        top->set_parent(__p);
 
         // clone right child node
         if(__x->m_right)
-            top->m_right = _copy(right(__x), top);
+            top->m_right = _copy(_right(__x), top);
         __p = top;
         __x = _left(__x);
 
@@ -523,9 +950,9 @@ private:
         while(__x != nullptr) {
             _Link_type y = _clone_node(__x);
             __p->m_left = y;
-            y->m_parent = __p;
+            y->set_parent(__p);
             if(__x->m_right)
-                y->m_right = _copy(right(__x), y);
+                y->m_right = _copy(_right(__x), y);
             __p = y;
             __x = _left(__x);
         }
@@ -545,12 +972,235 @@ private:
         }
     }
 
+    /**
+     * @brief   Take all nodes off the header
+     * @param   __bh: set to the black height of the nodes
+     * @return  The root of the nodes, whose parent is null
+     */
+    _Base_ptr _detach(int& __bh)
+    {
+        _Base_ptr root = _root();
+        __bh = __rb_tree_black_height(root);
+        if(root != nullptr)
+            root->set_parent(nullptr);
+        return root;
+    }
+
+    /**
+     * @brief   Hang the tree with root __root on the header
+     * @param   __n: number of nodes in the tree
+     */
+    void _attach(_Base_ptr __root, size_type __n)
+    {
+        _root() = (_Link_type)__root;
+        if(__root == nullptr) {
+            _leftmost() = m_header;
+            _rightmost() = m_header;
+        } else {
+            __root->set_parent(m_header);
+            _leftmost() = minimum(__root);
+            _rightmost() = maximum(__root);
+        }
+        m_node_count = __n;
+    }
+
+    /**
+     * @brief   Return the node with index __k in ascending
+     *          order, or m_header if there is no such node
+     */
+    _Base_ptr _nth(size_type __k) const
+    {
+        if(__k >= m_node_count)
+            return m_header;
+    #ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        _Base_ptr x = m_header->parent();
+        while(true) {
+            size_type left_n = __rb_tree_subtree_size(x->m_left);
+            if(__k < left_n)
+                x = x->m_left;
+            else if(__k == left_n)
+                return x;
+            else {
+                __k -= left_n + 1;
+                x = x->m_right;
+            }
+        }
+    #else
+        const_iterator it = begin();
+        __ADVANCE(it, __k);
+        return it.m_node;
+    #endif
+    }
+
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+    /**
+     * @brief   Return the index of __x in ascending order,
+     *          m_header is at index size()
+     */
+    size_type _index(_Base_ptr __x) const
+    {
+        if(__x == m_header)
+            return m_node_count;
+        size_type idx = __rb_tree_subtree_size(__x->m_left);
+        for(; __x != m_header->parent(); __x = __x->parent())
+            if(__x == __x->parent()->m_right)
+                idx += __rb_tree_subtree_size(__x->parent()->m_left) + 1;
+        return idx;
+    }
+#endif
+
+    /**
+     * @brief   Build a perfectly balanced subtree from the next
+     *          __n elements of a sorted range in linear time
+     * @param   __first: iterator to the next element, advanced
+     *          past the elements taken by the subtree
+     * @param   __n: number of elements in the subtree
+     * @param   __depth: depth of the subtree root
+     * @param   __red_depth: depth of the last, incomplete level
+     *          whose nodes are colored red
+     */
+    template <class _ForwardIter>
+    _Link_type _build_sorted(_ForwardIter& __first, size_type __n,
+                             size_type __depth, size_type __red_depth)
+    {
+        if(__n == 0)
+            return nullptr;
+
+        const size_type left_n = (__n - 1) / 2;
+        _Link_type left = _build_sorted(__first, left_n,
+                                        __depth + 1, __red_depth);
+        _Link_type top = nullptr;
+        __SSTL_TRY {
+            top = _create_node(*__first);
+            ++__first;
+            top->set_color(__depth == __red_depth ?
+                           __rb_tree_red : __rb_tree_black);
+            top->m_left = left;
+            top->m_right = _build_sorted(__first, __n - 1 - left_n,
+                                         __depth + 1, __red_depth);
+        }
+    #ifdef __SSTL_USE_EXCEPTIONS
+        catch(...) {
+            _erase(left);
+            if(top != nullptr)
+                _destroy_node(top);
+            throw;
+        }
+    #endif
+        if(left != nullptr)
+            left->set_parent(top);
+        if(top->m_right != nullptr)
+            top->m_right->set_parent(top);
+#ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        top->m_size = __n;
+#endif
+        return top;
+    }
+
+    /**
+     * @brief   Replace the contents with the __n elements of a
+     *          sorted range, without any comparison or rotation
+     */
+    template <class _ForwardIter>
+    void _assign_sorted(_ForwardIter __first, size_type __n)
+    {
+        clear();
+        if(__n == 0)
+            return;
+
+        // nodes above the depth floor(log2(n + 1)) form a complete
+        // tree and are black, so every path has the same black height
+        size_type red_depth = 0;
+        for(size_type full = __n + 1; full > 1; full >>= 1)
+            ++red_depth;
+
+        _root() = _build_sorted(__first, __n, 0, red_depth);
+        _root()->set_parent(m_header);
+        _leftmost() = minimum(_root());
+        _rightmost() = maximum(_root());
+        m_node_count = __n;
+    }
+
+    template <class _InputIter>
+    void _insert_unique_aux(_InputIter __first, _InputIter __last,
+                            input_iterator_tag)
+    {
+        for(; __first != __last; ++__first)
+            insert_unique(end(), *__first);
+    }
+
+    template <class _InputIter>
+    void _insert_unique_aux(_InputIter __first, _InputIter __last,
+                            std::input_iterator_tag)
+    { _insert_unique_aux(__first, __last, input_iterator_tag()); }
+
+    /**
+     * @brief   Forward iterators or better, sstl or std ones
+     */
+    template <class _ForwardIter, class _Category>
+    void _insert_unique_aux(_ForwardIter __first, _ForwardIter __last,
+                            _Category)
+    {
+        if(m_node_count == 0) {
+            // strictly increasing input can be built bottom-up
+            size_type n = 0;
+            _ForwardIter prev = __first, cur = __first;
+            for(; cur != __last; prev = cur, ++cur, ++n)
+                if(n > 0 && !m_key_compare(_KeyOfValue()(*prev),
+                                           _KeyOfValue()(*cur)))
+                    break;
+            if(cur == __last) {
+                _assign_sorted(__first, n);
+                return;
+            }
+        }
+        for(; __first != __last; ++__first)
+            insert_unique(end(), *__first);
+    }
+
+    template <class _InputIter>
+    void _insert_equal_aux(_InputIter __first, _InputIter __last,
+                           input_iterator_tag)
+    {
+        for(; __first != __last; ++__first)
+            insert_equal(end(), *__first);
+    }
+
+    template <class _InputIter>
+    void _insert_equal_aux(_InputIter __first, _InputIter __last,
+                           std::input_iterator_tag)
+    { _insert_equal_aux(__first, __last, input_iterator_tag()); }
+
+    /**
+     * @brief   Forward iterators or better, sstl or std ones
+     */
+    template <class _ForwardIter, class _Category>
+    void _insert_equal_aux(_ForwardIter __first, _ForwardIter __last,
+                           _Category)
+    {
+        if(m_node_count == 0) {
+            // non-decreasing input can be built bottom-up
+            size_type n = 0;
+            _ForwardIter prev = __first, cur = __first;
+            for(; cur != __last; prev = cur, ++cur, ++n)
+                if(n > 0 && m_key_compare(_KeyOfValue()(*cur),
+                                          _KeyOfValue()(*prev)))
+                    break;
+            if(cur == __last) {
+                _assign_sorted(__first, n);
+                return;
+            }
+        }
+        for(; __first != __last; ++__first)
+            insert_equal(end(), *__first);
+    }
+
     /**
      * @brief   initialize header with left, right and color
      */
     void _empty_initialize() {
         m_header = _allocate_node();
-        _color(m_header) = __rb_tree_red;
+        m_header->set_color(__rb_tree_red);
         _root() = 0;
         _leftmost() = m_header;
         _rightmost() = m_header;
@@ -571,17 +1221,20 @@ public:
 
     __rb_tree(const __rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& __x)
      : _Base(__x.get_allocator()), m_node_count(0), m_key_compare(__x.m_key_compare) {
-        if (__x._root() == nullptr) {
-            _empty_initialize();
-        } else {
-            _color(m_header) = __rb_tree_red;
+        _empty_initialize();
+        if (__x._root() != nullptr) {
             _root() = _copy(__x._root(), m_header);
             _leftmost() = minimum(_root());
             _rightmost() = maximum(_root());
+            m_node_count = __x.m_node_count;
         }
     }
 
-    ~__rb_tree() { clear(); }
+    ~__rb_tree()
+    {
+        clear();
+        _deallocate_node(m_header);
+    }
 
     __rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>&
     operator=(const __rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& __x)
@@ -589,7 +1242,7 @@ public:
         if(this == &__x)
             return *this;
 
-        clear(); // clear all old nodes
+        clear(); // old nodes go to the free list and are reused by _copy
         m_node_count = 0;
         m_key_compare = __x.m_key_compare;
         if(__x._root() == nullptr) { // __x is empty
@@ -616,10 +1269,15 @@ public:
      */
     iterator begin() { return _leftmost(); }
 
+    const_iterator begin() const { return _leftmost(); }
+
     /**
-     * @brief   Return an iterator to the rightmost node
+     * @brief   Return an iterator to the header node
+     *          following the rightmost node
      */
-    iterator end() { return _rightmost(); }
+    iterator end() { return m_header; }
+
+    const_iterator end() const { return m_header; }
 
     /**
      * @brief   Check whether the rb-tree is empty
@@ -670,6 +1328,45 @@ public:
         return y;
     }
 
+    /**
+     * @brief   Return an iterator pointing to the first element
+     *          that is not less than __k, starting the search at
+     *          __hint instead of the root. The search climbs from
+     *          __hint only up to the smallest subtree which holds
+     *          both __hint and the result, so stepping through the
+     *          tree in increasing keys skips subtrees cheaply
+     * @param   __hint: element at or before the result
+     * @param   __k: key value to search
+     */
+    const_iterator lower_bound(const_iterator __hint,
+                               const key_type& __k) const
+    {
+        _Base_ptr x = __hint.m_node;
+        if(x == m_header || !m_key_compare(_key(x), __k))
+            return lower_bound(__k);
+
+        // the parent of a left child comes after the whole child
+        while(x != _root() && (x->parent()->m_right == x ||
+                               m_key_compare(_key(x->parent()), __k)))
+            x = x->parent();
+        _Base_ptr y = x == _root() ? (_Base_ptr)m_header : x->parent();
+        while(x != nullptr) {
+            if(!m_key_compare(_key(x), __k)) {
+                y = x;
+                x = x->m_left;
+            } else
+                x = x->m_right;
+        }
+        return const_iterator((_Link_type)y);
+    }
+
+    iterator lower_bound(iterator __hint, const key_type& __k)
+    {
+        const_iterator it = ((const __rb_tree*)this)->lower_bound(
+                const_iterator((_Link_type)__hint.m_node), __k);
+        return iterator((_Link_type)it.m_node);
+    }
+
     /**
      * @brief   Returns an iterator pointing to the
      *          first element that is not larger than value
@@ -729,8 +1426,58 @@ public:
     size_type count(const key_type& __k) const
     {
         pair<const_iterator, const_iterator> p = equal_range(__k);
-        difference_type n = __DISTANCE(p.first, p.second);
-        return (size_type)n;
+        return (size_type)distance(p.first, p.second);
+    }
+
+    /**
+     * @brief   Return an iterator to the element with index __k
+     *          in ascending order, or end() if __k >= size().
+     *          Logarithmic with __SSTL_RB_TREE_ORDER_STATISTICS,
+     *          linear in __k otherwise
+     * @param   __k: zero-based index of the element
+     */
+    iterator nth(size_type __k)
+    { return (_Link_type)_nth(__k); }
+
+    const_iterator nth(size_type __k) const
+    { return (_Link_type)_nth(__k); }
+
+    /**
+     * @brief   Return the number of elements whose key is
+     *          less than __k, which is the index of lower_bound(__k)
+     * @param   __k: key value to compare the elements to
+     */
+    size_type rank(const key_type& __k) const
+    {
+    #ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        size_type r = 0;
+        _Link_type x = _root();
+        while(x != nullptr) {
+            if(m_key_compare(_key(x), __k)) { // x and its left subtree are less than __k
+                r += __rb_tree_subtree_size(x->m_left) + 1;
+                x = _right(x);
+            } else
+                x = _left(x);
+        }
+        return r;
+    #else
+        return (size_type)__DISTANCE(begin(), lower_bound(__k));
+    #endif
+    }
+
+    /**
+     * @brief   Return the number of increments from __first to __last
+     * @param   __first, __last: range of elements in rb-tree
+     */
+    difference_type distance(const_iterator __first,
+                             const_iterator __last) const
+    {
+    #ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        return (difference_type)_index(__last.m_node) -
+               (difference_type)_index(__first.m_node);
+    #else
+        return __DISTANCE(__first, __last);
+    #endif
     }
 
     /**
@@ -776,13 +1523,115 @@ public:
         return _insert(x, y, __val);
     }
 
+    /**
+     * @brief   Insert element which is not in rb-tree, using __pos
+     *          as a hint. Takes amortized constant time when the
+     *          element goes right before __pos, e.g. when keys
+     *          are appended in increasing order with end()
+     * @param   __pos: iterator to the position before which the
+     *          element is expected to be inserted
+     * @param   __val: value to insert
+     */
+    iterator insert_unique(iterator __pos, const value_type& __val)
+    {
+        if(__pos.m_node == m_header->m_left) { // begin()
+            if(m_node_count > 0 &&
+               m_key_compare(_KeyOfValue()(__val), _key(__pos.m_node)))
+                return _insert(__pos.m_node, __pos.m_node, __val);
+            return insert_unique(__val).first;
+        } else if(__pos.m_node == m_header) { // end()
+            if(m_key_compare(_key(_rightmost()), _KeyOfValue()(__val)))
+                return _insert(nullptr, _rightmost(), __val);
+            return insert_unique(__val).first;
+        }
+
+        iterator before = __pos;
+        --before;
+        if(m_key_compare(_key(before.m_node), _KeyOfValue()(__val)) &&
+           m_key_compare(_KeyOfValue()(__val), _key(__pos.m_node))) {
+            // either before has no right child or __pos has no left child
+            if(before.m_node->m_right == nullptr)
+                return _insert(nullptr, before.m_node, __val);
+            return _insert(__pos.m_node, __pos.m_node, __val);
+        }
+        return insert_unique(__val).first;
+    }
+
+    /**
+     * @brief   Insert element which may be existed, using __pos
+     *          as a hint. Takes amortized constant time when the
+     *          element goes right before __pos
+     * @param   __pos: iterator to the position before which the
+     *          element is expected to be inserted
+     * @param   __val: value to insert
+     */
+    iterator insert_equal(iterator __pos, const value_type& __val)
+    {
+        if(__pos.m_node == m_header->m_left) { // begin()
+            if(m_node_count > 0 &&
+               !m_key_compare(_key(__pos.m_node), _KeyOfValue()(__val)))
+                return _insert(__pos.m_node, __pos.m_node, __val);
+            return insert_equal(__val);
+        } else if(__pos.m_node == m_header) { // end()
+            if(!m_key_compare(_KeyOfValue()(__val), _key(_rightmost())))
+                return _insert(nullptr, _rightmost(), __val);
+            return insert_equal(__val);
+        }
+
+        iterator before = __pos;
+        --before;
+        if(!m_key_compare(_KeyOfValue()(__val), _key(before.m_node)) &&
+           !m_key_compare(_key(__pos.m_node), _KeyOfValue()(__val))) {
+            if(before.m_node->m_right == nullptr)
+                return _insert(nullptr, before.m_node, __val);
+            return _insert(__pos.m_node, __pos.m_node, __val);
+        }
+        return insert_equal(__val);
+    }
+
+    /**
+     * @brief   Insert elements in the range [__first, __last) which
+     *          are not in rb-tree. A sorted range inserted into an
+     *          empty tree is built in linear time
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class _InputIter>
+    void insert_unique(_InputIter __first, _InputIter __last)
+    {
+        _insert_unique_aux(__first, __last, __ITERATOR_CATEGORY(__first));
+    }
+
+    /**
+     * @brief   Insert all elements in the range [__first, __last).
+     *          A sorted range inserted into an empty tree is built
+     *          in linear time
+     * @param   __first, __last: range of elements to insert
+     */
+    template <class _InputIter>
+    void insert_equal(_InputIter __first, _InputIter __last)
+    {
+        _insert_equal_aux(__first, __last, __ITERATOR_CATEGORY(__first));
+    }
+
+    /**
+     * @brief   Replace the contents with the elements of a range
+     *          sorted by key, in linear time and without comparing
+     *          any keys. The range is trusted to be sorted
+     * @param   __first, __last: sorted range of elements
+     */
+    template <class _ForwardIter>
+    void assign_sorted(_ForwardIter __first, _ForwardIter __last)
+    {
+        _assign_sorted(__first, (size_type)__DISTANCE(__first, __last));
+    }
+
     /**
      * @brief   Find an element with key equivalent to key
      * @param   __k: keu value of the element to search for
      */
     iterator find(const key_type& __k)
     {
-        _Link_type y = m_header();
+        _Link_type y = m_header;
         _Link_type x = _root();
 
         while(x != 0) {
@@ -797,8 +1646,162 @@ public:
                end() : j;
     }
 
+    const_iterator find(const key_type& __k) const
+    {
+        const_iterator j = lower_bound(__k);
+        return j == end() || m_key_compare(__k, _key(j.m_node)) ?
+               end() : j;
+    }
+
+    /**
+     * @brief   Remove the element at __pos
+     * @param   __pos: iterator to the element to remove
+     */
+    void erase(iterator __pos)
+    {
+        _Link_type y = (_Link_type)__rb_tree_rebalance_for_erase(
+                __pos.m_node, m_header->m_parent,
+                m_header->m_left, m_header->m_right);
+        _destroy_node(y);
+        --m_node_count;
+    }
+
+    /**
+     * @brief   Remove the elements in the range [__first, __last)
+     * @param   __first, __last: range of elements to remove
+     */
+    void erase(iterator __first, iterator __last)
+    {
+        if(__first == begin() && __last == end()) {
+            clear();
+            return;
+        }
+        size_type n = (size_type)distance(__first, __last);
+        if(n < 16) { // short ranges are unlinked one by one
+            while(__first != __last)
+                erase(__first++);
+            return;
+        }
+
+        // cut the range out with two splits and join the rest,
+        // which takes O(n + log(size())) time
+        const size_type total = m_node_count;
+        int bh, abh, bbh, cbh = 0, mbh;
+        _Base_ptr a, b = _detach(bh), c = nullptr, m;
+        if(__last != end())
+            __rb_tree_split(bh, __last.m_node, b, bbh, c, cbh);
+        else
+            bbh = bh;
+        b->set_parent(nullptr);
+        __rb_tree_split(bbh, __first.m_node, a, abh, m, mbh);
+        _erase((_Link_type)m);
+        _destroy_node((_Link_type)__first.m_node);
+        if(__last != end())
+            a = __rb_tree_join(a, abh, __last.m_node, c, cbh, bh);
+        _attach(a, total - n);
+    }
+
+    /**
+     * @brief   Move the elements whose keys are not less than __k
+     *          to __right, replacing its contents. The trees are cut
+     *          in O(log n) time; counting the elements of the two
+     *          parts takes O(min(k, n - k)) more unless order
+     *          statistics are enabled
+     * @param   __k: key value to split at
+     * @param   __right: tree to receive the larger elements
+     */
+    void split(const key_type& __k, __rb_tree& __right)
+    {
+        __right.clear();
+        iterator pos = lower_bound(__k);
+        if(pos == end())
+            return;
+
+        const size_type total = m_node_count;
+        int bh, lbh, rbh;
+        _Base_ptr l, r;
+        _detach(bh);
+        __rb_tree_split(bh, pos.m_node, l, lbh, r, rbh);
+        r = __rb_tree_join(nullptr, 0, pos.m_node, r, rbh, rbh);
+        _attach(l, 0);
+        __right._attach(r, 0);
+
+    #ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        m_node_count = __rb_tree_subtree_size(l);
+    #else
+        // walk both parts together until the shorter one ends
+        size_type n = 0;
+        iterator i = begin(), j = __right.begin();
+        for(; i != end() && j != __right.end(); ++i, ++j)
+            ++n;
+        m_node_count = i == end() ? n : total - n;
+    #endif
+        __right.m_node_count = total - m_node_count;
+    }
+
+    /**
+     * @brief   Move all elements of __right to the end of rb-tree in
+     *          O(log n) time. No key of __right may be less than
+     *          a key in rb-tree, which is not checked
+     * @param   __right: tree whose elements are moved
+     */
+    void join(__rb_tree& __right)
+    {
+        if(this == &__right || __right.m_node_count == 0)
+            return;
+
+        const size_type total = m_node_count + __right.m_node_count;
+        _Base_ptr k = __rb_tree_rebalance_for_erase(__right._leftmost(),
+                __right.m_header->m_parent,
+                __right.m_header->m_left, __right.m_header->m_right);
+        int lbh, rbh, bh;
+        _Base_ptr l = _detach(lbh), r = __right._detach(rbh);
+        __right._attach(nullptr, 0);
+        _attach(__rb_tree_join(l, lbh, k, r, rbh, bh), total);
+    }
+
     /**
-     * @brief   Erase all elements from rb-tree
+     * @brief   Exchange the contents with other rb-tree
+     */
+    void swap(__rb_tree& __x)
+    {
+        sstl::swap(m_header, __x.m_header);
+        sstl::swap(m_node_count, __x.m_node_count);
+        sstl::swap(m_key_compare, __x.m_key_compare);
+    }
+
+    /**
+     * @brief   Remove all elements with key __k
+     * @param   __k: key value of the elements to remove
+     * @return  The number of elements removed
+     */
+    size_type erase(const key_type& __k)
+    {
+        pair<iterator, iterator> p = equal_range(__k);
+        size_type n = (size_type)distance(p.first, p.second);
+        erase(p.first, p.second);
+        return n;
+    }
+
+    /**
+     * @brief   Make sure that __n elements can be held without
+     *          requesting nodes from the allocator
+     * @param   __n: number of elements to hold
+     */
+    void reserve_nodes(size_type __n)
+    {
+        for(size_type held = m_node_count + m_free_count; held < __n; ++held)
+            _put_node(_allocate_node());
+    }
+
+    /**
+     * @brief   Return the nodes kept for reuse to the allocator
+     */
+    void release_nodes() { _release_free_nodes(); }
+
+    /**
+     * @brief   Erase all elements from rb-tree, keeping
+     *          their nodes for reuse
      */
     void clear() {
         if (m_node_count == 0)
@@ -809,6 +1812,87 @@ public:
         _rightmost() = m_header;
         m_node_count = 0;
     }
+
+    /**
+     * @brief   Check the red-black properties, the links to the
+     *          header, the order of the keys, the node count and
+     *          the subtree sizes. Meant for tests, it takes O(n)
+     */
+    bool __rb_verify() const
+    {
+        if(m_node_count == 0 || _root() == nullptr)
+            return m_node_count == 0 && _root() == nullptr &&
+                   _leftmost() == m_header && _rightmost() == m_header;
+        if(_root()->parent() != m_header || _color(_root()) != __rb_tree_black)
+            return false;
+        if(_leftmost() != minimum(_root()) || _rightmost() != maximum(_root()))
+            return false;
+        size_type n = 0;
+        if(_verify_subtree(_root(), n) < 0 || n != m_node_count)
+            return false;
+        const_iterator prev = begin();
+        for(const_iterator it = ++begin(); it != end(); prev = it, ++it)
+            if(m_key_compare(_KeyOfValue()(*it), _KeyOfValue()(*prev)))
+                return false;
+        return true;
+    }
+
+private:
+    /**
+     * @brief   Return the black height of the subtree of __x,
+     *          or -1 if it is broken, adding its nodes to __n
+     */
+    int _verify_subtree(_Base_ptr __x, size_type& __n) const
+    {
+        if(__x == nullptr)
+            return 0;
+        ++__n;
+        _Base_ptr l = __x->m_left;
+        _Base_ptr r = __x->m_right;
+        if((l != nullptr && l->parent() != __x) ||
+           (r != nullptr && r->parent() != __x))
+            return -1;
+        if(_color(__x) == __rb_tree_red &&
+           ((l != nullptr && _color(l) == __rb_tree_red) ||
+            (r != nullptr && _color(r) == __rb_tree_red)))
+            return -1;
+    #ifdef __SSTL_RB_TREE_ORDER_STATISTICS
+        if(__x->m_size != __rb_tree_subtree_size(l) +
+                          __rb_tree_subtree_size(r) + 1)
+            return -1;
+    #endif
+        const int lh = _verify_subtree(l, __n);
+        const int rh = _verify_subtree(r, __n);
+        if(lh < 0 || lh != rh)
+            return -1;
+        return lh + (_color(__x) == __rb_tree_black ? 1 : 0);
+    }
+};
+
+/**
+ * @brief   Skip the elements of a sorted container which are less
+ *          than a value, for the seeking set operations in
+ *          sstl_algo.h. One step is taken first and only a longer
+ *          run is skipped with the container's hinted lower_bound,
+ *          so merging containers of similar size costs no more than
+ *          stepping through them. The values must be the keys
+ */
+template <class _Container>
+struct __tree_seek {
+    typedef typename _Container::const_iterator _Iter;
+    typedef typename _Container::key_type _Key;
+
+    const _Container& m_c;
+
+    explicit __tree_seek(const _Container& __c): m_c(__c) {}
+
+    _Iter operator()(_Iter __first, _Iter __last, const _Key& __k) const
+    {
+        ++__first;
+        if(__first == __last || !m_c.key_comp()(*__first, __k))
+            return __first;
+        return m_c.lower_bound(__first, __k);
+    }
 };
 
 }; // sstl
@@ -23,6 +23,8 @@ public:
     _vector_base(size_t __n, const allocator_type&)
      : m_start(0), m_finish(0), m_end_of_storage(0)
     {
+        if(__n == 0)    // the pool has no free list for 0 bytes
+            return;
         m_start = _allocate(__n);
         m_finish = m_start;
         m_end_of_storage = m_start + __n;
@@ -35,8 +37,8 @@ protected:
     _Tp* _allocate(size_t __n) const
     { return m_data_allocator::allocate(__n); }
 
-    void _deallocate(_Tp* __p, size_t)
-    { m_data_allocator::deallocate(m_start, m_end_of_storage - m_start); }
+    void _deallocate(_Tp* __p, size_t __n)
+    { if(__p) m_data_allocator::deallocate(__p, __n); }
 
     template <class ForwardIter>
     _Tp* _allocate_and_copy(size_t __n, ForwardIter __first, ForwardIter __last)
@@ -94,9 +96,9 @@ protected:
     void _expand_and_insert(iterator __pos, const value_type& __val)
     {
         if (m_finish != m_end_of_storage) { // enough space to insert
-            construct(m_finish, *(m_finish - 1));
+            sstl::construct(m_finish, *(m_finish - 1));
             ++m_finish;
-            copy_backward(__pos, m_finish - 2, m_finish - 1); // move all elements one step forward
+            sstl::copy_backward(__pos, m_finish - 2, m_finish - 1); // move all elements one step forward
             value_type x_copy = __val; // call copy constructor
             *__pos = x_copy;
         }
@@ -110,19 +112,19 @@ protected:
             __SSTL_TRY
             {
                 // copy all elements before insert position into new room
-                new_finish = uninitialized_copy(m_start, __pos, new_start);
-                construct(new_finish, __val);
+                new_finish = sstl::uninitialized_copy(m_start, __pos, new_start);
+                sstl::construct(new_finish, __val);
                 ++new_finish;
-                new_finish = uninitialized_copy(__pos, m_finish, new_finish);
+                new_finish = sstl::uninitialized_copy(__pos, m_finish, new_finish);
             }
 #ifdef __SSTL_USE_EXCEPTIONS
             catch(...) {
-                destroy(new_start, new_finish);
+                sstl::destroy(new_start, new_finish);
                 _deallocate(new_start, new_size);
                 throw;
             }
 #endif
-            destroy(begin(), end());
+            sstl::destroy(begin(), end());
             _deallocate(m_start, m_end_of_storage - m_start);
             m_start = new_start;
             m_finish = new_finish;
@@ -139,7 +141,7 @@ protected:
     void _vector_aux(Integer __n, Integer __val, __true_type)
     {
         m_start = _allocate(__n);
-        m_finish = uninitialized_fill_n(m_start, __n, __val);
+        m_finish = sstl::uninitialized_fill_n(m_start, __n, __val);
         m_end_of_storage = m_finish;
     }
 
@@ -155,7 +157,7 @@ public:
     vector<_Tp, _Alloc>&
     operator=(const vector<_Tp, _Alloc>& __x)
     {
-        if(*this == __x)
+        if(this == &__x)
             return *this;
 
         const size_type len = __x.size();
@@ -167,7 +169,7 @@ public:
             m_end_of_storage = m_start + len;
         } else if(size() >= len) { // have to destroy some old elements
             iterator tmp = sstl::copy(__x.begin(), __x.end(), begin());
-            destroy(tmp, m_finish);
+            sstl::destroy(tmp, m_finish);
         } else {
             sstl::copy(__x.begin(), __x.begin()+size(), m_start);
             sstl::uninitialized_copy(__x.begin() + size(), __x.end(), m_finish);
@@ -179,7 +181,7 @@ public:
     /**
      * @brief   Returns the allocator associated with the container
      */
-    allocator_type get_allocator()
+    allocator_type get_allocator() const
      { return _Base::get_allocator(); }
 
     /**
@@ -232,16 +234,19 @@ public:
 
     explicit vector(size_type __n)
      : _Base(__n, allocator_type())
-    { uninitialized_fill_n(m_start, __n, value_type()); }
+    { m_finish = sstl::uninitialized_fill_n(m_start, __n, value_type()); }
 
     vector(size_type __n, const value_type& __val,
            const allocator_type& __alloc = allocator_type())
      : _Base(__n, __alloc)
-    { uninitialized_fill_n(m_start, __n, __val); }
+    { m_finish = sstl::uninitialized_fill_n(m_start, __n, __val); }
 
-    explicit vector(const vector<value_type, allocator_type>& __x)
+    vector(const vector<_Tp, _Alloc>& __x)
      : _Base(__x.size(), __x.get_allocator())
-    { m_finish = uninitialized_copy(__x.begin(), __x.end(), value_type()); }
+    {
+        if(!__x.empty())
+            m_finish = sstl::uninitialized_copy(__x.begin(), __x.end(), m_start);
+    }
 
     template <class _InputIter>
     vector(_InputIter __first, _InputIter __last,
@@ -261,11 +266,13 @@ public:
      * @brief   Return the first element
      */
     reference front() { return *m_start; }
+    const_reference front() const { return *m_start; }
 
     /**
      * @brief   Return the last element
      */
     reference back() { return *(m_finish - 1); }
+    const_reference back() const { return *(m_finish - 1); }
 
     /**
      * @brief   Add the element to the end
@@ -274,7 +281,7 @@ public:
     void push_back(const value_type& __val)
     {
         if(m_finish != m_end_of_storage) {
-            construct(m_finish, __val);
+            sstl::construct(m_finish, __val);
             ++m_finish;
         }
         else
@@ -285,19 +292,21 @@ public:
      * @brief   Insert element at the specified position
      * @param   __pos: iterator before the content which will be inserted
      * @param   __val: element value to insert
+     * @return  Iterator to the inserted element
      */
-    void insert(iterator __pos, const value_type& __val)
+    iterator insert(iterator __pos, const value_type& __val)
     {
         size_type n = __pos - m_start;
         if(m_finish != m_end_of_storage && __pos == m_finish) {
-            construct(__pos, __val);
+            sstl::construct(__pos, __val);
             ++m_finish;
         }
         else
             _expand_and_insert(__pos, __val);
+        return m_start + n;
     }
 
-    void insert(iterator __pos) { insert(__pos, value_type()); }
+    iterator insert(iterator __pos) { return insert(__pos, value_type()); }
 
     /**
      * @brief   Insert elements at the specified position from other container
@@ -348,12 +357,12 @@ public:
         #ifdef __SSTL_USE_EXCEPTIONS
             catch(...)
             {
-                destroy(new_start, new_finish);
+                sstl::destroy(new_start, new_finish);
                 _deallocate(new_start, new_size);
                 throw;
             }
         #endif
-            destroy(m_start, m_finish);
+            sstl::destroy(m_start, m_finish);
             _deallocate(m_start, m_end_of_storage - m_start);
             m_start = new_start;
             m_finish = new_finish;
@@ -367,7 +376,7 @@ public:
     void pop_back()
     {
         if(m_finish != m_start) {
-            destroy(--m_finish);
+            sstl::destroy(--m_finish);
         }
     }
 
@@ -389,8 +398,8 @@ public:
      * @param   __first, __last: range of elements to remove
      */
     iterator erase(iterator __first, iterator __last) {
-        iterator tmp = copy(__last, m_finish, __first); // move forward
-        destroy(tmp, m_finish);
+        iterator tmp = sstl::copy(__last, m_finish, __first); // move forward
+        sstl::destroy(tmp, m_finish);
         m_finish = m_finish - (__last - __first);
         return __first;
     }
@@ -409,7 +418,7 @@ public:
         if(__n_size < size())
             erase(m_start + __n_size, end());
         else
-            insert(m_start + __n_size, value_type());
+            insert(end(), __n_size - size(), value_type());
     }
 
     /**
@@ -422,7 +431,7 @@ public:
         if(capacity() < __n) {
             const size_type old_size = size();
             iterator tmp = _allocate_and_copy(__n, m_start, m_finish);
-            destroy(m_start, m_finish);
+            sstl::destroy(m_start, m_finish);
             _deallocate(m_start, m_end_of_storage - m_start);
             m_start = tmp;
             m_finish = tmp + old_size;
@@ -438,7 +447,7 @@ public:
     {
         sstl::swap(m_start, __x.m_start);
         sstl::swap(m_finish, __x.m_finish);
-        sstl::swap(m_end_of_storage, m_end_of_storage);
+        sstl::swap(m_end_of_storage, __x.m_end_of_storage);
     }
 };
 
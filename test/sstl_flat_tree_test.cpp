@@ -0,0 +1,56 @@
+// Tests of vector copies and of flat_set and flat_map built on it.
+// Build and run with
+//   g++ -std=c++11 -I../src sstl_flat_tree_test.cpp && ./a.out
+
+#include <cassert>
+#include <cstdio>
+#include "sstl_vector.h"
+#include "sstl_flat_set.h"
+#include "sstl_flat_map.h"
+
+static void test_copy_empty()
+{
+    sstl::vector<int> v;
+    sstl::vector<int> cv(v);
+    assert(cv.empty() && cv.capacity() == 0);
+    cv.push_back(1);
+    assert(cv.size() == 1 && cv[0] == 1);
+
+    sstl::flat_set<int> s;
+    sstl::flat_set<int> cs(s);
+    assert(cs.empty());
+    cs.insert(3);
+    assert(cs.size() == 1);
+
+    sstl::flat_map<int, int> m;
+    sstl::flat_map<int, int> cm(m);
+    assert(cm.empty());
+    cm[2] = 4;
+    assert(cm.size() == 1 && cm[2] == 4);
+}
+
+static void test_fitted_capacity()
+{
+    for(int n = 0; n <= 40; ++n) {
+        sstl::flat_set<int> s;
+        for(int i = 0; i < n; ++i)
+            s.insert(i);
+        s.shrink_to_fit();
+        assert(s.size() == size_t(n) && s.capacity() == s.size());
+
+        sstl::vector<int> v;
+        for(int i = 0; i < n; ++i)
+            v.push_back(2 * i);
+        sstl::flat_set<int> sorted(sstl::from_sorted, v.begin(), v.end());
+        assert(sorted.size() == size_t(n) && sorted.capacity() == sorted.size());
+        assert(n == 0 || *sorted.begin() == 0);
+    }
+}
+
+int main()
+{
+    test_copy_empty();
+    test_fitted_capacity();
+    std::puts("sstl_flat_tree_test passed");
+    return 0;
+}
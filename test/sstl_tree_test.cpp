@@ -0,0 +1,170 @@
+// Tests of __rb_tree and of set and map built on it. Build and run with
+// each node layout, e.g.
+//   g++ -std=c++11 -I../src sstl_tree_test.cpp && ./a.out
+//   g++ -std=c++11 -I../src -D__SSTL_RB_TREE_ORDER_STATISTICS sstl_tree_test.cpp
+//   g++ -std=c++11 -I../src -D__SSTL_RB_TREE_COMPACT_NODES sstl_tree_test.cpp
+//   g++ -std=c++11 -I../src -D__SSTL_RB_TREE_ORDER_STATISTICS
+//       -D__SSTL_RB_TREE_COMPACT_NODES sstl_tree_test.cpp
+
+#include <cassert>
+#include <cstdio>
+#include <vector>
+#include <list>
+#include "sstl_set.h"
+#include "sstl_map.h"
+
+typedef sstl::__rb_tree<int, int, sstl::identity<int>, std::less<int>,
+                        __SSTL_DEFAULT_ALLOC> int_tree;
+
+static void test_assign_sorted()
+{
+    for(int n = 0; n <= 130; ++n) {
+        std::vector<int> v;
+        for(int i = 0; i < n; ++i)
+            v.push_back(2 * i);
+
+        int_tree t;
+        t.assign_sorted(v.begin(), v.end());
+        assert(t.__rb_verify());
+        assert(t.size() == size_t(n));
+        int i = 0;
+        for(int_tree::iterator it = t.begin(); it != t.end(); ++it, ++i)
+            assert(*it == 2 * i);
+
+        // raw pointers and non random access std iterators
+        if(n > 0) {
+            t.assign_sorted(&v[0], &v[0] + n);
+            assert(t.__rb_verify() && t.size() == size_t(n));
+        }
+        std::list<int> l(v.begin(), v.end());
+        t.assign_sorted(l.begin(), l.end());
+        assert(t.__rb_verify() && t.size() == size_t(n));
+
+        // the tree stays valid through later inserts and erases
+        for(int k = 1; k < 2 * n; k += 4)
+            t.insert_unique(k);
+        for(int k = 0; k < 2 * n; k += 6)
+            t.erase(k);
+        assert(t.__rb_verify());
+    }
+}
+
+static void test_range_construction()
+{
+    const int a[] = {1, 2, 3, 5, 8, 13, 21};
+    const int n = sizeof(a) / sizeof(a[0]);
+
+    sstl::set<int> s(a, a + n);
+    assert(s.size() == size_t(n) && *s.begin() == 1);
+
+    sstl::set<int> sorted(sstl::from_sorted, a, a + n);
+    assert(sorted.size() == size_t(n));
+    sstl::set<int>::iterator it = sorted.begin();
+    for(int i = 0; i < n; ++i, ++it)
+        assert(*it == a[i]);
+
+    std::vector<int> v(a, a + n);
+    sstl::set<int> from_vector(sstl::from_sorted, v.begin(), v.end());
+    assert(from_vector.size() == size_t(n));
+    std::list<int> l(a, a + n);
+    sstl::set<int> from_list(l.begin(), l.end());
+    assert(from_list.size() == size_t(n));
+
+    // unsorted and duplicate input takes the inserting path
+    const int b[] = {5, 1, 5, 3, 1};
+    sstl::set<int> u(b, b + 5);
+    assert(u.size() == 3 && *u.begin() == 1);
+
+    typedef sstl::pair<const int, int> value_type;
+    std::vector<value_type> pv;
+    for(int i = 0; i < 50; ++i)
+        pv.push_back(value_type(i, i * i));
+    sstl::map<int, int> m(pv.begin(), pv.end());
+    sstl::map<int, int> ms(sstl::from_sorted, pv.begin(), pv.end());
+    assert(m.size() == 50 && ms.size() == 50);
+    assert(ms[7] == 49 && m[49] == 49 * 49);
+}
+
+static void fill(int_tree& __t, int __n)
+{
+    __t.clear();
+    for(int i = 0; i < __n; ++i)
+        __t.insert_unique(i);
+}
+
+static void test_erase_range()
+{
+    const int n = 200;
+    int_tree t;
+    // ranges left of, around and right of the middle, and at both ends
+    const int ranges[][2] = {
+        {10, 40}, {20, 100}, {90, 120}, {100, 180}, {150, 200},
+        {0, 16}, {0, 150}, {184, 200}, {1, 199}, {0, 200}, {50, 66}
+    };
+    for(size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+        fill(t, n);
+        int_tree::iterator first = t.find(ranges[r][0]);
+        int_tree::iterator last = ranges[r][1] == n ? t.end() : t.find(ranges[r][1]);
+        t.erase(first, last);
+        assert(t.__rb_verify());
+        assert(t.size() == size_t(n - (ranges[r][1] - ranges[r][0])));
+        for(int i = 0; i < n; ++i)
+            assert(t.count(i) == size_t(i < ranges[r][0] || i >= ranges[r][1]));
+    }
+}
+
+static void test_split_join()
+{
+    const int n = 300;
+    for(int k = -1; k <= n + 1; k += 7) {
+        int_tree l, r;
+        fill(l, n);
+        l.insert_unique(1000);  // r gets replaced
+        fill(r, 20);
+        l.erase(1000);
+        l.split(k, r);
+        assert(l.__rb_verify() && r.__rb_verify());
+        const int cut = k < 0 ? 0 : k > n ? n : k;
+        assert(l.size() == size_t(cut) && r.size() == size_t(n - cut));
+        if(!r.empty())
+            assert(*r.begin() == cut);
+
+        l.join(r);
+        assert(l.__rb_verify() && r.__rb_verify());
+        assert(l.size() == size_t(n) && r.empty());
+        int i = 0;
+        for(int_tree::iterator it = l.begin(); it != l.end(); ++it, ++i)
+            assert(*it == i);
+    }
+
+    // joins of trees of very different heights
+    for(int a = 0; a <= 64; a += 16)
+        for(int b = 0; b <= 300; b += 60) {
+            int_tree l, r;
+            for(int i = 0; i < a; ++i)
+                l.insert_unique(i);
+            for(int i = 0; i < b; ++i)
+                r.insert_unique(a + i);
+            l.join(r);
+            assert(l.__rb_verify() && l.size() == size_t(a + b));
+        }
+
+    sstl::set<int> s, right;
+    for(int i = 0; i < 100; ++i)
+        s.insert(i);
+    s.split(40, right);
+    assert(s.size() == 40 && right.size() == 60);
+    s.join(right);
+    s.erase(s.find(10), s.find(90));
+    assert(s.size() == 20 && right.empty());
+}
+
+int main()
+{
+    test_assign_sorted();
+    test_range_construction();
+    test_erase_range();
+    test_split_join();
+    std::puts("sstl_tree_test passed");
+    return 0;
+}